@@ -0,0 +1,311 @@
+/**
+ * @file Benchmarks of TinyLog : throughput, latency percentiles and allocations per call.
+ *
+ * Usage : bench_tinylog [filter] [iterations]
+ *      filter      Only runs the benchmarks whose name contains this string
+ *      iterations  Calls per benchmark and per thread, 200000 by default
+ */
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include <tinylog.hpp>
+
+#include "../test/allocation_counter.hpp"
+
+/**
+ * @brief A sink discarding everything, so that benchmarks measure TinyLog rather than the I/O
+ */
+class DiscardingSink : public TinyLog::Sink {
+public:
+    void write(std::string_view data, const TinyLog::LogRecord*) override {
+        writtenBytes += data.size();
+    }
+
+    size_t writtenBytes = 0;
+};
+
+/**
+ * @brief How a benchmark sets up TinyLog
+ */
+struct BenchmarkSetup {
+    int stringSinksCount = 1;
+    int jsonSinksCount = 0;
+    int threadsCount = 1;
+    bool isAsync = false;
+    TinyLog::LogLevel sinksMinLogLevel = TinyLog::DEBUG;
+    TinyLog::AsyncQueueMode asyncQueueMode = TinyLog::AsyncQueueMode::SHARED;
+    /// @brief The layout of the string sinks, the built-in one if empty
+    const char* stringLayout = "";
+};
+
+/**
+ * @brief The measures of a benchmark
+ */
+struct BenchmarkResult {
+    double nanosecondsPerCall = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double allocationsPerCall = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Depth of the asynchronous queue in the asynchronous benchmarks
+static constexpr long long asyncQueueDepth = 8192;
+
+/// @brief The sinks of the current benchmark
+static std::vector<std::unique_ptr<DiscardingSink>> sinks;
+
+static void setUpOutputs(const BenchmarkSetup& setup) {
+    TinyLog::Logger::disableStringOutput();
+    TinyLog::Logger::disableJsonOutput();
+    sinks.clear();
+    TinyLog::PatternLayout layout;
+    if (*setup.stringLayout != '\0')
+        layout = TinyLog::PatternLayout(setup.stringLayout);
+    for (int i = 0; i < setup.stringSinksCount; i++) {
+        sinks.push_back(std::make_unique<DiscardingSink>());
+        if (i == 0)
+            TinyLog::Logger::enableStringOutput(*sinks.back(), setup.sinksMinLogLevel, layout);
+        else
+            TinyLog::Logger::addStringOutput(*sinks.back(), setup.sinksMinLogLevel, layout);
+    }
+    for (int i = 0; i < setup.jsonSinksCount; i++) {
+        sinks.push_back(std::make_unique<DiscardingSink>());
+        if (i == 0)
+            TinyLog::Logger::enableJsonOutput(*sinks.back(), TinyLog::JsonFormat::ARRAY, setup.sinksMinLogLevel);
+        else
+            TinyLog::Logger::addJsonOutput(*sinks.back(), TinyLog::JsonFormat::ARRAY, setup.sinksMinLogLevel);
+    }
+    if (setup.isAsync)
+        TinyLog::Logger::enableAsyncMode(asyncQueueDepth, TinyLog::AsyncOverflowPolicy::BLOCK, setup.asyncQueueMode);
+}
+
+static double getPercentile(std::vector<double>& latencies, double percentile) {
+    if (latencies.empty())
+        return 0;
+    size_t index = std::min(latencies.size() - 1, static_cast<size_t>(percentile * latencies.size()));
+    std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+    return latencies[index];
+}
+
+/**
+ * @brief Runs the given function on `threadsCount` threads. With a single thread, runs it on the calling thread, so
+ *      that it sees the logger chain of the caller.
+ */
+static void runOnThreads(int threadsCount, const std::function<void(int)>& function) {
+    if (threadsCount == 1) {
+        function(0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < threadsCount; thread++) {
+        threads.emplace_back(function, thread);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Runs the given call `iterations` times per thread, first as a batch for the throughput, then timing each call
+ *      for the latency percentiles.
+ */
+static BenchmarkResult runBenchmark(const BenchmarkSetup& setup, long long iterations, const std::function<void(long long)>& call) {
+    setUpOutputs(setup);
+    BenchmarkResult result;
+
+    // Warm-up, so that the buffers (including every slot of the asynchronous queues) reach their steady-state size
+    // Runs on as many threads as the benchmark, whose queues per thread are then reused by the benchmark threads
+    long long warmUpIterations = setup.isAsync ? 2 * asyncQueueDepth : 1000;
+    runOnThreads(setup.threadsCount, [&](int) {
+        for (long long i = 0; i < warmUpIterations; i++) {
+            call(i);
+        }
+    });
+    TinyLog::Logger::flush();
+
+    // Throughput
+    long long allocationsBefore = allocationsCount.load();
+    Clock::time_point start = Clock::now();
+    runOnThreads(setup.threadsCount, [&](int) {
+        for (long long i = 0; i < iterations; i++) {
+            call(i);
+        }
+    });
+    TinyLog::Logger::flush();
+    double elapsedNanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    long long callsCount = iterations * setup.threadsCount;
+    result.nanosecondsPerCall = elapsedNanoseconds / callsCount;
+    result.allocationsPerCall = static_cast<double>(allocationsCount.load() - allocationsBefore) / callsCount;
+
+    // Latency of each call, as seen by the calling thread
+    std::vector<std::vector<double>> threadLatencies(setup.threadsCount);
+    for (std::vector<double>& latencies : threadLatencies) {
+        latencies.reserve(iterations);
+    }
+    runOnThreads(setup.threadsCount, [&](int thread) {
+        std::vector<double>& latencies = threadLatencies[thread];
+        for (long long i = 0; i < iterations; i++) {
+            Clock::time_point callStart = Clock::now();
+            call(i);
+            latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - callStart).count());
+        }
+    });
+    TinyLog::Logger::flush();
+    std::vector<double> latencies;
+    for (const std::vector<double>& threadLatency : threadLatencies) {
+        latencies.insert(latencies.end(), threadLatency.begin(), threadLatency.end());
+    }
+    result.p50 = getPercentile(latencies, 0.50);
+    result.p99 = getPercentile(latencies, 0.99);
+    result.p999 = getPercentile(latencies, 0.999);
+
+    TinyLog::Logger::disableAsyncMode();
+    return result;
+}
+
+/**
+ * @brief A named benchmark
+ */
+struct Benchmark {
+    std::string name;
+    BenchmarkSetup setup;
+    std::function<void(long long)> call;
+};
+
+/**
+ * @brief Returns the median time between two consecutive clock reads, included in every latency measure
+ */
+static double measureTimerOverhead() {
+    std::vector<double> latencies;
+    for (int i = 0; i < 10000; i++) {
+        Clock::time_point start = Clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return getPercentile(latencies, 0.50);
+}
+
+static void printHeader() {
+    std::cout << "Latencies include a timer overhead of about " << measureTimerOverhead() << " ns" << std::endl;
+    std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(16) << "throughput"
+              << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "p999 ns"
+              << std::setw(20) << "allocations" << std::endl;
+}
+
+static void printResult(const std::string& name, const BenchmarkResult& result) {
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << result.nanosecondsPerCall << " ns/op"
+              << std::setw(10) << result.p50 << std::setw(10) << result.p99 << std::setw(10) << result.p999
+              << std::setw(10) << std::setprecision(2) << result.allocationsPerCall << " allocs/op" << std::endl;
+}
+
+/**
+ * @brief Calls `function` from the bottom of a chain of `depth` loggers set to `INHERIT`
+ */
+static void callFromInheritChain(int depth, const std::function<void()>& function) {
+    if (depth == 0) {
+        function();
+        return;
+    }
+    TinyLog::Logger logger(TinyLog::INHERIT);
+    callFromInheritChain(depth - 1, function);
+}
+
+int main(int argc, char** argv) {
+    std::string filter = (argc > 1) ? argv[1] : "";
+    long long iterations = (argc > 2) ? std::atoll(argv[2]) : 200000;
+
+    TinyLog::Logger logger(TinyLog::INFO);
+
+    // Formats a log without writing it anywhere, to measure the formatting alone
+    std::string_view formattedExtras[] = {"First extra", "Second extra"};
+    TinyLog::LogRecord formattedRecord{TinyLog::WARN, TinyLog::LogClock::now(), true, "bench/bench_tinylog.cpp", 1234,
+                                       "Benchmark message", formattedExtras, 2};
+    TinyLog::FormatBuffer formatBuffer;
+
+    std::vector<Benchmark> benchmarks = {
+        {"filtered_out", {1, 0, 1, false}, [&](long long) { TinyLog_log(TinyLog::DEBUG, "Filtered out", "Extra"); }},
+        {"filtered_out_4_threads", {1, 0, 4, false}, [&](long long) { TinyLog_log(TinyLog::DEBUG, "Filtered out", "Extra"); }},
+        {"filtered_out_by_sinks", {1, 1, 1, false, TinyLog::ERROR}, [&](long long) { TinyLog_log(TinyLog::INFO, "Filtered out", "Extra"); }},
+        {"string_1_sink", {1, 0, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"json_1_sink", {0, 1, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"json_escaped_long_message", {0, 1, 1, false}, [&](long long) {
+            TinyLog_log(TinyLog::INFO, "A long message, mostly free of characters to escape, as most messages are : only a \"few\" here and there,\n"
+                                       "so that the escaping spends its time looking for them rather than escaping them.", "C:\\path\\to\\file");
+        }},
+        {"pattern_layout", {1, 0, 1, false, TinyLog::DEBUG, TinyLog::AsyncQueueMode::SHARED, "%t %-5L %f:%l %m"},
+         [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"format_string_only", {0, 0, 1, false}, [&](long long) {
+            formatBuffer.clear();
+            TinyLog::Logger::formatString(formatBuffer, formattedRecord);
+        }},
+        {"string_and_json", {1, 1, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"string_4_sinks", {4, 0, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"string_16_sinks", {16, 0, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"extras_2", {1, 0, 1, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message", "First extra", "Second extra"); }},
+        {"extras_8", {1, 0, 1, false}, [&](long long) {
+            TinyLog_log(TinyLog::INFO, "Benchmark message", "1", "2", "3", "4", "5", "6", "7", "8");
+        }},
+        {"fields_4", {0, 1, 1, false}, [&](long long i) {
+            TinyLog_logf(TinyLog::INFO, "Benchmark message", TinyLog::field("iteration", i), TinyLog::field("ratio", 0.5),
+                         TinyLog::field("isValid", true), TinyLog::field("name", "Name"));
+        }},
+        {"logger_scope", {1, 0, 1, false}, [&](long long) {
+            TinyLog::Logger scope(TinyLog::WARN);
+            TinyLog_logc(scope, TinyLog::INFO, "Filtered out");
+        }},
+        {"scoped_log_level", {1, 0, 1, false}, [&](long long) {
+            TinyLog::ScopedLogLevel scope(TinyLog::WARN);
+            TinyLog_logc(scope, TinyLog::INFO, "Filtered out");
+        }},
+        {"log_context_2_fields", {1, 0, 1, false}, [&](long long) {
+            TinyLog::LogContext context({TinyLog::field("requestId", "0123456789abcdef"), TinyLog::field("tenantId", 42)});
+            TinyLog_log(TinyLog::INFO, "Benchmark message");
+        }},
+        {"debug_expression", {1, 0, 1, false}, [&](long long i) { TinyLog_log(TinyLog::INFO, "Benchmark message", TinyLog_debug_expression(i)); }},
+        {"string_4_threads", {1, 0, 4, false}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"async_string_1_sink", {1, 0, 1, true}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"async_string_4_threads", {1, 0, 4, true}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"async_per_thread_4_threads", {1, 0, 4, true, TinyLog::DEBUG, TinyLog::AsyncQueueMode::PER_THREAD},
+         [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message"); }},
+        {"async_json_extras_2", {0, 1, 1, true}, [&](long long) { TinyLog_log(TinyLog::INFO, "Benchmark message", "First extra", "Second extra"); }},
+    };
+
+    printHeader();
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+            continue;
+        printResult(benchmark.name, runBenchmark(benchmark.setup, iterations, benchmark.call));
+    }
+
+    // Deep INHERIT chains are measured from the bottom of the chain, built once per benchmark
+    for (int depth : {16, 256}) {
+        for (bool isFiltered : {false, true}) {
+            std::string name = "inherit_chain_" + std::to_string(depth) + (isFiltered ? "_filtered_out" : "");
+            if (!filter.empty() && name.find(filter) == std::string::npos)
+                continue;
+            callFromInheritChain(depth, [&]() {
+                printResult(name, runBenchmark({1, 0, 1, false}, iterations, [&](long long) {
+                    if (isFiltered)
+                        TinyLog_log(TinyLog::DEBUG, "Benchmark message");
+                    else
+                        TinyLog_log(TinyLog::INFO, "Benchmark message");
+                }));
+            });
+        }
+    }
+
+    TinyLog::Logger::disableStringOutput();
+    TinyLog::Logger::disableJsonOutput();
+    return 0;
+}
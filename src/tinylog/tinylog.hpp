@@ -7,7 +7,88 @@
 #include <cassert>
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <type_traits>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TINYLOG_HAS_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <signal.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#else
+#define TINYLOG_HAS_POSIX 0
+#endif
+
+/// @brief If set to 1, `RollingFileSink` can compress its archives with gzip. Requires linking zlib. Is 0 by default.
+#ifndef TINYLOG_USE_ZLIB
+#define TINYLOG_USE_ZLIB 0
+#endif
+#if TINYLOG_USE_ZLIB == 1
+#include <zlib.h>
+#endif
+
+/// @brief If set to 1, `RollingFileSink` can compress its archives with zstd. Requires linking libzstd. Is 0 by default.
+#ifndef TINYLOG_USE_ZSTD
+#define TINYLOG_USE_ZSTD 0
+#endif
+#if TINYLOG_USE_ZSTD == 1
+#include <zstd.h>
+#endif
+
+/// @brief If set to 0, TinyLog doesn't use SIMD instructions, e.g. to escape JSON strings. Is 1 by default.
+#ifndef TINYLOG_USE_SIMD
+#define TINYLOG_USE_SIMD 1
+#endif
+
+#if TINYLOG_USE_SIMD == 1 && defined(__AVX2__)
+#define TINYLOG_HAS_AVX2 1
+#include <immintrin.h>
+#else
+#define TINYLOG_HAS_AVX2 0
+#endif
+
+#if TINYLOG_USE_SIMD == 1 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINYLOG_HAS_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define TINYLOG_HAS_SSE2 0
+#endif
+
+#if TINYLOG_USE_SIMD == 1 && defined(__ARM_NEON) && defined(__aarch64__)
+#define TINYLOG_HAS_NEON 1
+#include <arm_neon.h>
+#else
+#define TINYLOG_HAS_NEON 0
+#endif
 
 /// @brief Current version of TinyLog. Follows [Semantic Versioning](https://semver.org/).
 #define TINYLOG_VERSION "0.6.0"
@@ -36,17 +117,109 @@
 #endif
 #endif
 
+/// @brief Logs below this LogLevel are removed at compile time by the logging macros and by `Logger::log<LogLevel>()`.
+///     DEBUG (nothing removed) by default.
+#ifndef TINYLOG_COMPILE_MIN_LEVEL
+#define TINYLOG_COMPILE_MIN_LEVEL DEBUG
+#endif
+
 /// @brief If set to 1, log extras will be put on their own separate lines
 #ifndef TINYLOG_EXTRAS_ON_SEPARATE_LINES
 #define TINYLOG_EXTRAS_ON_SEPARATE_LINES 0
 #endif
 
+/// @brief How many loggers and `ScopedLogLevel`s the logger chain of a thread holds at most, in a fixed-size array
+#ifndef TINYLOG_LOGGER_CHAIN_DEPTH
+#define TINYLOG_LOGGER_CHAIN_DEPTH 256
+#endif
+
+/// @brief Default amount of log records the asynchronous queue can hold. Rounded up to a power of two.
+#ifndef TINYLOG_ASYNC_DEFAULT_QUEUE_DEPTH
+#define TINYLOG_ASYNC_DEFAULT_QUEUE_DEPTH 8192
+#endif
+
+/// @brief Maximum time, in milliseconds, the asynchronous writer thread sleeps before checking the queue again
+#ifndef TINYLOG_ASYNC_IDLE_WAIT_MS
+#define TINYLOG_ASYNC_IDLE_WAIT_MS 5
+#endif
+
+/// @brief If 1, every `FATAL` log is followed by a `Logger::flush()`, waiting for it to be written in asynchronous mode
+#ifndef TINYLOG_FLUSH_ON_FATAL
+#define TINYLOG_FLUSH_ON_FATAL 1
+#endif
+
+/// @brief Maximum time, in milliseconds, `Logger::emergencyFlush()` waits for the asynchronous writer thread to drain the queue
+#ifndef TINYLOG_EMERGENCY_FLUSH_TIMEOUT_MS
+#define TINYLOG_EMERGENCY_FLUSH_TIMEOUT_MS 1000
+#endif
+
+/// @brief Size, in bytes, of the buffer preallocated by `Logger::enableCrashHandler()` to format the log of the crash
+#ifndef TINYLOG_EMERGENCY_BUFFER_SIZE
+#define TINYLOG_EMERGENCY_BUFFER_SIZE 4096
+#endif
+
+/// @brief Maximum amount of fields a thread can have in its `LogContext`
+#ifndef TINYLOG_CONTEXT_MAX_FIELDS
+#define TINYLOG_CONTEXT_MAX_FIELDS 16
+#endif
+
+/// @brief Size, in bytes, of the arena each thread copies the keys and the string values of its `LogContext` into
+#ifndef TINYLOG_CONTEXT_ARENA_SIZE
+#define TINYLOG_CONTEXT_ARENA_SIZE 1024
+#endif
+
+/// @brief Default size, in bytes, of the buffer of a `FileSink`
+#ifndef TINYLOG_FILE_SINK_BUFFER_SIZE
+#define TINYLOG_FILE_SINK_BUFFER_SIZE 65536
+#endif
+
+/// @brief Default size, in bytes, above which a `BatchingSink` writes its batch
+#ifndef TINYLOG_BATCH_DEFAULT_SIZE
+#define TINYLOG_BATCH_DEFAULT_SIZE 65536
+#endif
+
+/// @brief One log out of this many is timed by the metrics, the others being extrapolated from it. 0 disables the timing.
+#ifndef TINYLOG_METRICS_TIMING_PERIOD
+#define TINYLOG_METRICS_TIMING_PERIOD 64
+#endif
+
+/// @brief Default maximal size, in bytes, of the logs a `NetworkSink` holds while they wait to be sent
+#ifndef TINYLOG_NETWORK_SPILL_DEFAULT_SIZE
+#define TINYLOG_NETWORK_SPILL_DEFAULT_SIZE (4 * 1024 * 1024)
+#endif
+
+/// @brief Default size, in bytes, of the logs kept by a `RingFileSink`
+#ifndef TINYLOG_RING_FILE_DEFAULT_CAPACITY
+#define TINYLOG_RING_FILE_DEFAULT_CAPACITY (16 * 1024 * 1024)
+#endif
+
+/// @brief Default size, in bytes, of the ring of each process in the segment of a `SharedMemorySink`
+#ifndef TINYLOG_SHARED_MEMORY_DEFAULT_RING_CAPACITY
+#define TINYLOG_SHARED_MEMORY_DEFAULT_RING_CAPACITY (1024 * 1024)
+#endif
+
+/// @brief Default size, in bytes, above which a `RollingFileSink` rotates its file
+#ifndef TINYLOG_ROLLING_FILE_DEFAULT_MAX_SIZE
+#define TINYLOG_ROLLING_FILE_DEFAULT_MAX_SIZE (10 * 1024 * 1024)
+#endif
+
+/// @brief Minimum time, in milliseconds, between two summaries of the logs suppressed at a call site by its sampling or rate limit
+#ifndef TINYLOG_SUPPRESSED_SUMMARY_INTERVAL_MS
+#define TINYLOG_SUPPRESSED_SUMMARY_INTERVAL_MS 1000
+#endif
+
 #ifdef SOURCE_PATH_SIZE
 #define __FILENAME__ (__FILE__ + SOURCE_PATH_SIZE)
 #else
 #define __FILENAME__ __FILE__
 #endif
 
+#if TINYLOG_USE_NAMESPACE == 1
+#define TINYLOG_NAMESPACE TinyLog::
+#else
+#define TINYLOG_NAMESPACE
+#endif
+
 #if TINYLOG_USE_NAMESPACE == 1
 namespace TinyLog {
 #endif
@@ -61,283 +234,6346 @@ enum LogLevel: char {
     INHERIT = -1
 };
 
+/// @brief The lowest log level kept at compile time, see `TINYLOG_COMPILE_MIN_LEVEL`
+constexpr LogLevel compileMinLogLevel = TINYLOG_COMPILE_MIN_LEVEL;
+
 /**
- * @brief Returns the stringified version of the given log level
+ * @brief Returns whether logs of the given level are kept at compile time
  * @param logLevel A log level
- * @param doPad If true, adds spaces at the end of the returned string until the string is 5 characters long
- * @returns The name of the log level, as a string
- */
-std::string getLogLevelName(LogLevel logLevel, bool doPad = false) {
-    std::string returnString = "";
-    switch (logLevel) {
-        case DEBUG:   returnString = "DEBUG"; break;
-        case INFO:    returnString = "INFO"; break;
-        case WARN:    returnString = "WARN"; break;
-        case ERROR:   returnString = "ERROR"; break;
-        case FATAL:   returnString = "FATAL"; break;
-        case INHERIT: returnString = "INHERIT"; break;
-        default: std::terminate();
-    }
-    if (doPad) {
-        while (returnString.size() < 5)
-            returnString += " ";
-    }
-    return returnString;
+ * @returns Whether `logLevel` is at least `TINYLOG_COMPILE_MIN_LEVEL`.
+ */
+constexpr bool isCompiledLogLevel(LogLevel logLevel) {
+    return static_cast<char>(logLevel) >= static_cast<char>(compileMinLogLevel);
 }
 
-class Logger  {
-private:
-    /// @brief A list of loggers as a hierarchy
-    inline static std::vector<Logger*> loggers{};
-
-    /// @brief A vector of pointers to the output stream for the string logging
-    inline static std::vector<std::ostream*> stringOutputStreams = {};
-
-    /// @brief Whether string logging is enabled
-    inline static bool isStringOutputEnabled = false;
+/**
+ * @brief What to do when a log is sent while the asynchronous queue is full
+ */
+enum class AsyncOverflowPolicy: char {
+    /// @brief The logging thread waits until the writer thread frees a slot
+    BLOCK = 0,
+    /// @brief The log being sent is discarded
+    DROP_NEWEST,
+    /// @brief The oldest log still waiting in the queue is discarded to make room for the new one
+    DROP_OLDEST
+};
 
-    /// @brief A vector of pointer to the output streams for JSON logging
-    inline static std::vector<std::ostream*> jsonOutputStreams = {};
+/**
+ * @brief How the logs of the asynchronous mode are queued
+ */
+enum class AsyncQueueMode: char {
+    /// @brief A single queue, shared by every thread
+    SHARED = 0,
+    /// @brief A queue per thread, only written by this thread ; the writer thread merges them by timestamp
+    PER_THREAD
+};
 
-    /// @brief Whether JSON logging is enabled
-    inline static bool isJsonOutputEnabled = false;
+/**
+ * @brief How a JSON output lays out its logs
+ */
+enum class JsonFormat: char {
+    /// @brief A single JSON array holding every log, only valid once the output is disabled
+    ARRAY = 0,
+    /// @brief Newline-delimited JSON : one JSON object per line, each line being valid on its own
+    NDJSON
+};
 
-    /// @brief How many logs have been sent to JSON
-    inline static long long jsonOutputsCount = 0;
+/**
+ * @brief The resolution of the timestamps in the logs
+ */
+enum class TimestampPrecision: char {
+    /// @brief `2025-11-17T12:00:00Z`
+    SECONDS = 0,
+    /// @brief `2025-11-17T12:00:00.123Z`
+    MILLISECONDS,
+    /// @brief `2025-11-17T12:00:00.123456Z`
+    MICROSECONDS
+};
 
-    /// @brief The log level for this logger
-    LogLevel currentLogLevel;
+/// @brief The clock the timestamps of the logs come from
+using LogClock = std::chrono::system_clock;
 
-public:
-    explicit Logger(LogLevel logLevel = INHERIT) {
-        loggers.push_back(this);
-        currentLogLevel = logLevel;
-    }
+/// @brief The names of the log levels, indexed by log level + 1
+inline constexpr std::string_view logLevelNames[] = {"INHERIT", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+/// @brief The names of the log levels, padded with spaces to 5 characters, indexed by log level + 1
+inline constexpr std::string_view paddedLogLevelNames[] = {"INHERIT", "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL"};
 
-    ~Logger() {
-        disableStringOutput();
-        disableJsonOutput();
-    }
+/**
+ * @brief Returns the stringified version of the given log level
+ * @param logLevel A log level
+ * @param doPad If true, the name is padded with spaces at the end until it is 5 characters long
+ * @returns The name of the log level, pointing to a static string
+ */
+constexpr std::string_view getLogLevelName(LogLevel logLevel, bool doPad = false) {
+    if (logLevel < INHERIT || logLevel > FATAL)
+        std::terminate();
+    return doPad ? paddedLogLevelNames[logLevel + 1] : logLevelNames[logLevel + 1];
+}
 
-    /**
-     * @brief Returns the log level for this logger, going back up the chain of loggers until one isn't set to INHERIT.
-     * @note If every logger in the chain's log level is set to `INHERIT` (including the top-most logger's), then the value
-     *      of the macro `TINYLOG_DEFAULT_LOG_LEVEL` is returned.
-     * @returns A log level.
-     */
-    LogLevel getLogLevel() const {
-        int currentLoggerIndex = loggers.size() - 1;
-        assert(currentLoggerIndex >= 0);
-        while (loggers[currentLoggerIndex]->currentLogLevel == INHERIT) {
-            if (currentLoggerIndex == 0)
-                return TINYLOG_DEFAULT_LOG_LEVEL;
-            currentLoggerIndex -= 1;
+/**
+ * @brief Reads a log level from its name
+ * @param name The name of a log level, as returned by `getLogLevelName()`, in any case and possibly padded with spaces
+ * @param logLevel Set to the log level if the name is valid, left untouched otherwise
+ * @returns Whether the name is the one of a log level.
+ */
+inline bool parseLogLevel(std::string_view name, LogLevel& logLevel) {
+    while (!name.empty() && name.back() == ' ')
+        name.remove_suffix(1);
+    static constexpr std::pair<std::string_view, LogLevel> logLevels[] = {
+        {"DEBUG", DEBUG}, {"INFO", INFO}, {"WARN", WARN}, {"ERROR", ERROR}, {"FATAL", FATAL}, {"INHERIT", INHERIT}
+    };
+    for (const auto& [logLevelName, value] : logLevels) {
+        if (name.size() == logLevelName.size()
+            && std::equal(name.begin(), name.end(), logLevelName.begin(), [](char a, char b) { return (a & ~0x20) == b; })) {
+            logLevel = value;
+            return true;
         }
-        return loggers[currentLoggerIndex]->currentLogLevel;
     }
+    return false;
+}
 
-    /**
-     * @brief Logs the given message if the given log level is above the current log level
-     * @param givenLogLevel The log level for this log
-     * @param message The message to log
-     * @param extras An ensemble of strings to be displayed after the message
-     * @param filePath The path to the file where this function is called. Not displayed by default.
-     * @param lineNumber The line number of the file where this function is called. Not displayed by default.
-     */
-    void log(LogLevel givenLogLevel, const std::string& message, std::initializer_list<std::string> extras = {}, std::string filePath = "", int lineNumber = -1, bool showTimestamp = true) {
-        // Shortcut to exit the function if the log level does not match
-        if (static_cast<char>(givenLogLevel) < static_cast<char>(getLogLevel())) return;
+/**
+ * @brief A logging statement of the source code, described once by the logging macros.
+ * @note Each `TinyLog_log`/`TinyLog_logc` statement holds a static call site, initialized at compile time, so the
+ *      file path and line number don't cost anything at runtime : logs only carry a pointer to it. Outputs can use
+ *      this pointer to identify the statement a log comes from.
+ * @note A call site is registered the first time it logs, after which `CallSite::forEach()` lists it. Disabling a call
+ *      site with `setEnabled(false)` skips its statement before the message and the extras are evaluated.
+ * @note A call site can be sampled, only logging 1 in N times, and rate limited with a token bucket. Both are checked
+ *      by `shouldLog()` before the message and the extras are evaluated ; the logs they suppress are counted, and
+ *      summarized by a "Suppressed N messages" log from the call site.
+ */
+struct CallSite {
+    constexpr CallSite(const char* callSiteFilePath, int callSiteLineNumber, LogLevel callSiteLogLevel) :
+        filePath(callSiteFilePath, getLength(callSiteFilePath)), lineNumber(callSiteLineNumber), logLevel(callSiteLogLevel) {}
 
-        // String output
-        if (isStringOutputEnabled) {
-            for (std::ostream* stringOutputStream : stringOutputStreams) {
-                logToStringOutputStream(stringOutputStream, givenLogLevel, showTimestamp, filePath, lineNumber, message, extras);
-            }
-        }
+    CallSite(const CallSite&) = delete;
+    CallSite& operator=(const CallSite&) = delete;
 
-        // JSON output
-        if (isJsonOutputEnabled) {
-            // Copies strings and escapes quotes inside them
-            std::string messageCopy = message;
-            std::vector<std::string> extrasCopy = extras;
-            std::replace(messageCopy.begin(), messageCopy.end(), '\"', '\'');
-            for (std::string& extra : extrasCopy) {
-                std::replace(extra.begin(), extra.end(), '\"', '\'');
-            }
+    const std::string_view filePath;
+    const int lineNumber;
+    const LogLevel logLevel;
 
-            for (std::ostream* jsonOutputStream : jsonOutputStreams) {
-                logToJsonOutputStream(jsonOutputStream, givenLogLevel, showTimestamp, filePath, lineNumber, messageCopy, extrasCopy);
-            }
+    /// @brief Returns whether this call site logs
+    bool isEnabled() const {
+        return flags.load(std::memory_order_relaxed) & ENABLED;
+    }
 
-            // Remembers how many JSON logs have been outputted
-            jsonOutputsCount++;
-        }
+    /// @brief Sets whether this call site logs
+    void setEnabled(bool isCallSiteEnabled) {
+        if (isCallSiteEnabled)
+            flags.fetch_or(ENABLED, std::memory_order_relaxed);
+        else
+            flags.fetch_and(static_cast<unsigned char>(~ENABLED), std::memory_order_relaxed);
+    }
+
+    /// @brief Returns whether this call site is sampled or rate limited
+    bool isLimited() const {
+        return flags.load(std::memory_order_relaxed) & LIMITED;
     }
 
     /**
-     * @brief Enables logging to a given stream, as a string output.
-     * @param outputStream An output stream for the logging. Example : std::cout
+     * @brief Returns whether the next log from this call site should be logged : whether the call site is enabled, and
+     *      the log is neither sampled out nor over the rate limit. Counts the log as suppressed otherwise.
+     * @note Costs a single relaxed atomic load for call sites that are neither sampled nor rate limited.
      */
-    static void enableStringOutput(std::ostream& outputStream) {
-        isStringOutputEnabled = true;
-        addStringOutput(outputStream);
+    bool shouldLog() {
+        unsigned char currentFlags = flags.load(std::memory_order_relaxed);
+        if (currentFlags == ENABLED)
+            return true;
+        return (currentFlags & ENABLED) && isAdmitted();
     }
 
     /**
-     * @bref Adds another output stream to the string output.
-     * @param outputStream An output stream for the logging. Example : std::cout
+     * @brief Only logs 1 in `period` logs from this call site
+     * @param period How many logs there are for each one logged. 0 or 1 logs them all.
      */
-    static void addStringOutput(std::ostream& outputStream) {
-        assert(isStringOutputEnabled);
-        stringOutputStreams.push_back(&outputStream);
+    void setSampling(std::uint32_t period) {
+        samplingPeriod.store(period, std::memory_order_relaxed);
+        updateLimitedFlag();
     }
 
     /**
-     * @brief Disables logging as a string output.
-     * @warning Clears the previous output streams with no further processing.
+     * @brief Limits the logs from this call site with a token bucket, refilled at a given rate
+     * @param messagesPerSecond How many logs per second are logged in the long run. 0 or less removes the rate limit.
+     * @param burst How many logs in a row are logged before the rate applies, i.e. the size of the bucket
      */
-    static void disableStringOutput() {
-        stringOutputStreams.clear();
-        isStringOutputEnabled = false;
+    void setRateLimit(double messagesPerSecond, std::uint32_t burst = 1) {
+        long long interval = (messagesPerSecond > 0) ? std::max(1LL, static_cast<long long>(1e9 / messagesPerSecond)) : 0;
+        emissionInterval.store(interval, std::memory_order_relaxed);
+        burstTolerance.store(interval * (std::max<std::uint32_t>(burst, 1) - 1), std::memory_order_relaxed);
+        updateLimitedFlag();
+    }
+
+    /// @brief Returns how many logs from this call site were suppressed since their last summary
+    std::uint64_t getSuppressedCount() const {
+        return suppressedCount.load(std::memory_order_relaxed);
     }
 
     /**
-     * @brief Enables logging to a given stream, as a JSON output.
-     * @param outputStream An output stream for the logging. Example : std::cout
+     * @brief Takes the count of the suppressed logs to summarize, resetting it
+     * @param isForced Whether to take it even if the last summary is less than `TINYLOG_SUPPRESSED_SUMMARY_INTERVAL_MS` old
+     * @returns How many logs were suppressed since the last summary, or 0 if there is nothing to summarize yet.
      */
-    static void enableJsonOutput(std::ostream& outputStream) {
-        isJsonOutputEnabled = true;
-        jsonOutputsCount = 0;
-        addJsonOutput(outputStream);
+    std::uint64_t takeSuppressedCount(bool isForced = false) {
+        if (suppressedCount.load(std::memory_order_relaxed) == 0)
+            return 0;
+        long long now = getSteadyNanoseconds();
+        long long lastSummaryTime = lastSummaryNanoseconds.load(std::memory_order_relaxed);
+        if (isForced) {
+            lastSummaryNanoseconds.store(now, std::memory_order_relaxed);
+        } else if (now - lastSummaryTime < TINYLOG_SUPPRESSED_SUMMARY_INTERVAL_MS * 1000000LL
+                   || !lastSummaryNanoseconds.compare_exchange_strong(lastSummaryTime, now, std::memory_order_relaxed)) {
+            return 0;
+        }
+        return suppressedCount.exchange(0, std::memory_order_relaxed);
+    }
+
+    /// @brief Registers this call site, if it isn't registered yet
+    void registerOnce() {
+        if (isRegistered.load(std::memory_order_relaxed) || isRegistered.exchange(true, std::memory_order_relaxed))
+            return;
+        CallSite* head = registeredCallSites.load(std::memory_order_relaxed);
+        do {
+            next = head;
+        } while (!registeredCallSites.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
     }
 
     /**
-     * @bref Adds another output stream to the JSON output.
-     * @param outputStream An output stream for the logging. Example : std::cout
+     * @brief Calls the given function with every registered call site, most recently registered first
+     * @param function Any callable taking a `CallSite&`
      */
-    static void addJsonOutput(std::ostream& outputStream) {
-        assert(isJsonOutputEnabled);
-        jsonOutputStreams.push_back(&outputStream);
-        outputStream << "[";
+    template <typename Function>
+    static void forEach(Function&& function) {
+        for (CallSite* callSite = registeredCallSites.load(std::memory_order_acquire); callSite != nullptr; callSite = callSite->next) {
+            function(*callSite);
+        }
     }
 
     /**
-     * @brief Disables logging as a JSON output.
-     * @warning Clears the previous output streams with minor processing.
+     * @brief Enables or disables the registered call sites of the given file
+     * @param callSitesFilePath The file path of the call sites, as logged
+     * @param callSitesLineNumber The line number of the call site, or -1 for every call site of the file
+     * @param isCallSiteEnabled Whether these call sites log
+     * @returns How many call sites were changed
      */
-    static void disableJsonOutput() {
-        for (std::ostream* outputStream : jsonOutputStreams) {
-            *outputStream << "]";
-        }
-        jsonOutputStreams.clear();
-        isJsonOutputEnabled = false;
-        jsonOutputsCount = 0;
+    static int setEnabled(std::string_view callSitesFilePath, int callSitesLineNumber, bool isCallSiteEnabled) {
+        return forEachMatching(callSitesFilePath, callSitesLineNumber, [&](CallSite& callSite) {
+            callSite.setEnabled(isCallSiteEnabled);
+        });
     }
 
     /**
-     * @brief Returns whether the string output is enabled
-     * @note This function should be marked as const, but is a static function.
-     * @returns Whether the string output is enabled.
+     * @brief Sets the sampling of the registered call sites of the given file, see the non-static `setSampling()`
+     * @param callSitesFilePath The file path of the call sites, as logged
+     * @param callSitesLineNumber The line number of the call site, or -1 for every call site of the file
+     * @param period How many logs there are for each one logged
+     * @returns How many call sites were changed
      */
-    static bool isEnabledStringOutput() {
-        return isStringOutputEnabled;
+    static int setSampling(std::string_view callSitesFilePath, int callSitesLineNumber, std::uint32_t period) {
+        return forEachMatching(callSitesFilePath, callSitesLineNumber, [&](CallSite& callSite) {
+            callSite.setSampling(period);
+        });
     }
 
     /**
-     * @brief Pre-allocates enough space for n loggers
-     * @param capacity The new logger chain capacity
-     * @warning `capacity` must be higher than the current amount of loggers in the chain. An assertion will check that.
+     * @brief Sets the rate limit of the registered call sites of the given file, see the non-static `setRateLimit()`
+     * @param callSitesFilePath The file path of the call sites, as logged
+     * @param callSitesLineNumber The line number of the call site, or -1 for every call site of the file
+     * @param messagesPerSecond How many logs per second each call site logs in the long run
+     * @param burst How many logs in a row each call site logs before the rate applies
+     * @returns How many call sites were changed
      */
-    static void setLoggerChainCapacity(size_t capacity) {
-        assert(capacity > loggers.size());  // Avoids UB
-        loggers.reserve(capacity);
+    static int setRateLimit(std::string_view callSitesFilePath, int callSitesLineNumber, double messagesPerSecond, std::uint32_t burst = 1) {
+        return forEachMatching(callSitesFilePath, callSitesLineNumber, [&](CallSite& callSite) {
+            callSite.setRateLimit(messagesPerSecond, burst);
+        });
     }
 
 private:
+    /// @brief The bits of `flags`
+    enum Flags: unsigned char {
+        ENABLED = 1,
+        LIMITED = 2
+    };
+
+    /// @brief Calls the given function with every registered call site of the given file and line, and returns how many there were
+    template <typename Function>
+    static int forEachMatching(std::string_view callSitesFilePath, int callSitesLineNumber, Function&& function) {
+        int matchingCount = 0;
+        forEach([&](CallSite& callSite) {
+            if (callSite.filePath == callSitesFilePath && (callSitesLineNumber == -1 || callSite.lineNumber == callSitesLineNumber)) {
+                function(callSite);
+                matchingCount++;
+            }
+        });
+        return matchingCount;
+    }
+
+    static long long getSteadyNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void updateLimitedFlag() {
+        if (samplingPeriod.load(std::memory_order_relaxed) > 1 || emissionInterval.load(std::memory_order_relaxed) > 0)
+            flags.fetch_or(LIMITED, std::memory_order_relaxed);
+        else
+            flags.fetch_and(static_cast<unsigned char>(~LIMITED), std::memory_order_relaxed);
+    }
+
     /**
-     * @brief Calculates the ISO 8601 timestamp, and returns it.
-     * @returns The current ISO 8601 timestamp.
+     * @brief Applies the sampling, then the rate limit, to a log from this call site
+     * @note The rate limit is a token bucket, implemented as the generic cell rate algorithm : rather than a number of
+     *      tokens, it keeps the theoretical time of the next log, which a single compare-and-swap moves forward.
      */
-    std::string getIso8601Timestamp() {
-        std::time_t now;
-        std::time(&now);
-        char timestampBuffer[sizeof "1970-01-01T00:00:00Z"];
-        std::strftime(timestampBuffer, sizeof timestampBuffer, "%FT%TZ", std::gmtime(&now));
-        return timestampBuffer;
+    bool isAdmitted() {
+        std::uint32_t period = samplingPeriod.load(std::memory_order_relaxed);
+        if (period > 1 && sampledLogsCount.fetch_add(1, std::memory_order_relaxed) % period != 0) {
+            suppressedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        long long interval = emissionInterval.load(std::memory_order_relaxed);
+        if (interval > 0) {
+            long long now = getSteadyNanoseconds();
+            long long tolerance = burstTolerance.load(std::memory_order_relaxed);
+            long long arrival = theoreticalArrival.load(std::memory_order_relaxed);
+            long long nextArrival;
+            do {
+                long long start = std::max(arrival, now);
+                if (start - now > tolerance) {
+                    suppressedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                nextArrival = start + interval;
+            } while (!theoreticalArrival.compare_exchange_weak(arrival, nextArrival, std::memory_order_relaxed));
+        }
+        return true;
     }
 
     /**
-     * @brief Escapes the given string's double quotes
-     * @param stringToEscape A string with possibly double quotes inside, to be escaped.
-     * @warning This operation is in place.
+     * @brief Returns the length of the given string
+     * @note Unlike `std::char_traits::length()`, always evaluated at compile time for a static call site, so that the
+     *      call site is initialized at compile time rather than on its first use.
      */
-    void escapeString(std::string& stringToEscape) {
-        std::replace(stringToEscape.begin(), stringToEscape.end(), '\"', '\'');
+    static constexpr size_t getLength(const char* string) {
+        size_t length = 0;
+        while (string[length] != '\0')
+            length++;
+        return length;
+    }
+
+    std::atomic<unsigned char> flags{ENABLED};
+    std::atomic<bool> isRegistered{false};
+
+    std::atomic<std::uint32_t> samplingPeriod{0};
+    std::atomic<std::uint32_t> sampledLogsCount{0};
+    /// @brief Nanoseconds between two logs under the rate limit, 0 without rate limit
+    std::atomic<long long> emissionInterval{0};
+    /// @brief How far ahead of the current time, in nanoseconds, the theoretical arrival time can be
+    std::atomic<long long> burstTolerance{0};
+    std::atomic<long long> theoreticalArrival{0};
+    std::atomic<std::uint64_t> suppressedCount{0};
+    std::atomic<long long> lastSummaryNanoseconds{0};
+    CallSite* next = nullptr;
+
+    /// @brief The most recently registered call site, heading the list of every registered call site
+    inline static std::atomic<CallSite*> registeredCallSites{nullptr};
+};
+
+/**
+ * @brief The type of the value of a `Field`
+ */
+enum class FieldType: char {
+    INTEGER = 0,
+    UNSIGNED_INTEGER,
+    FLOATING_POINT,
+    BOOLEAN,
+    STRING,
+    /// @brief A `std::chrono::duration`, stored as nanoseconds
+    DURATION
+};
+
+/**
+ * @brief A typed key/value pair attached to a log, created with `field()`.
+ * @note The value is stored as it is, and only formatted by the outputs : JSON outputs write numbers and booleans as
+ *      such, rather than as strings.
+ * @note Only holds views : the key and the string values belong to the caller of `Logger::log()`.
+ */
+struct Field {
+    std::string_view key;
+    FieldType type = FieldType::INTEGER;
+    union {
+        long long integer = 0;
+        unsigned long long unsignedInteger;
+        double floatingPoint;
+        bool boolean;
+        /// @brief The duration of `DURATION` fields
+        long long nanoseconds;
+    };
+    /// @brief The value of `STRING` fields
+    std::string_view string;
+};
+
+/// @brief Whether the given type is a `std::chrono::duration`
+template <typename Type>
+struct IsDuration : std::false_type {};
+
+template <typename Rep, typename Period>
+struct IsDuration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+/**
+ * @brief Creates a typed field, to be logged with `Logger::log()` or the `TinyLog_logf` macro.
+ * @param key The name of the field
+ * @param value An integer, a floating-point number, a boolean, a string or a `std::chrono::duration`. Strings aren't
+ *      copied, and must outlive the call to `Logger::log()`.
+ */
+template <typename Value>
+Field field(std::string_view key, const Value& value) {
+    Field newField;
+    newField.key = key;
+    if constexpr (std::is_same_v<Value, bool>) {
+        newField.type = FieldType::BOOLEAN;
+        newField.boolean = value;
+    } else if constexpr (std::is_integral_v<Value> && std::is_signed_v<Value>) {
+        newField.type = FieldType::INTEGER;
+        newField.integer = value;
+    } else if constexpr (std::is_integral_v<Value>) {
+        newField.type = FieldType::UNSIGNED_INTEGER;
+        newField.unsignedInteger = value;
+    } else if constexpr (std::is_floating_point_v<Value>) {
+        newField.type = FieldType::FLOATING_POINT;
+        newField.floatingPoint = static_cast<double>(value);
+    } else if constexpr (IsDuration<Value>::value) {
+        newField.type = FieldType::DURATION;
+        newField.nanoseconds = std::chrono::duration_cast<std::chrono::duration<long long, std::nano>>(value).count();
+    } else {
+        static_assert(std::is_convertible_v<const Value&, std::string_view>,
+                      "A field must be an integer, a floating-point number, a boolean, a string or a duration");
+        newField.type = FieldType::STRING;
+        newField.string = value;
     }
+    return newField;
+}
 
+/**
+ * @brief Fields added to every log of the current thread while it is alive, e.g. a request ID (a mapped diagnostic context).
+ * @note The fields are copied once, when the context is created, into a fixed thread-local arena : creating a context
+ *      never allocates, and logs only point to the arena, until the asynchronous mode copies the logs it queues.
+ *      Fields beyond `TINYLOG_CONTEXT_MAX_FIELDS`, or whose strings don't fit in the `TINYLOG_CONTEXT_ARENA_SIZE` bytes
+ *      of the arena, are ignored.
+ * @note Contexts are scopes : they must be destroyed in the reverse order of their creation. A key added again by an
+ *      inner context is logged twice.
+ */
+class LogContext {
+public:
     /**
-     * @brief Logs to the given outputs stream, as a string
+     * @brief Adds the given fields to the context of the current thread, until this context is destroyed
+     * @param contextFields Created with `TinyLog::field()` ; their strings are copied.
      */
-    void logToStringOutputStream(std::ostream *stringOutputStream, LogLevel givenLogLevel, bool showTimestamp, const std::string& filePath, int lineNumber, const std::string& message, std::initializer_list<std::string>& extras) {
-        assert(stringOutputStream != nullptr);
-        std::string logLevelName = getLogLevelName(givenLogLevel, true);
-        *stringOutputStream << "[" << logLevelName << "] ";
-        if (showTimestamp) {
-            std::string timestamp = getIso8601Timestamp();
-            *stringOutputStream << timestamp << " - ";
-        }
-        if (filePath != "") {
-            *stringOutputStream << filePath << " ";
+    LogContext(std::initializer_list<Field> contextFields) {
+        Arena& currentArena = arena;
+        previousFieldsCount = currentArena.fieldsCount;
+        previousTextSize = currentArena.textSize;
+        for (const Field& contextField : contextFields) {
+            currentArena.push(contextField);
         }
-        if (lineNumber != -1) {
-            *stringOutputStream << "(line " << lineNumber << ") ";
-        }
-        if (filePath != "" || lineNumber != -1) {
-            *stringOutputStream << "- ";
+    }
+
+    /// @brief Adds the given field to the context of the current thread, until this context is destroyed
+    template <typename Value>
+    LogContext(std::string_view key, const Value& value) : LogContext({field(key, value)}) {}
+
+    ~LogContext() {
+        Arena& currentArena = arena;
+        currentArena.fieldsCount = previousFieldsCount;
+        currentArena.textSize = previousTextSize;
+    }
+
+    LogContext(const LogContext&) = delete;
+    LogContext& operator=(const LogContext&) = delete;
+
+    /// @brief Returns the fields of the context of the current thread, outermost first
+    static const Field* getFields() {
+        return arena.fields;
+    }
+
+    /// @brief Returns how many fields the context of the current thread has
+    static size_t getFieldsCount() {
+        return arena.fieldsCount;
+    }
+
+private:
+    /// @brief The fields of the contexts of a thread, and the characters of their keys and string values
+    struct Arena {
+        Field fields[TINYLOG_CONTEXT_MAX_FIELDS];
+        size_t fieldsCount;
+        char text[TINYLOG_CONTEXT_ARENA_SIZE];
+        size_t textSize;
+
+        /// @brief Copies the given field into the arena, unless it is full
+        void push(const Field& contextField) {
+            if (fieldsCount == TINYLOG_CONTEXT_MAX_FIELDS)
+                return;
+            size_t stringSize = (contextField.type == FieldType::STRING) ? contextField.string.size() : 0;
+            if (textSize + contextField.key.size() + stringSize > sizeof text)
+                return;
+            Field& copiedField = fields[fieldsCount++];
+            copiedField = contextField;
+            copiedField.key = copy(contextField.key);
+            if (contextField.type == FieldType::STRING)
+                copiedField.string = copy(contextField.string);
         }
-        *stringOutputStream << message;
-        if (extras.size() > 0) {
-            *stringOutputStream << " - EXTRAS " << ((TINYLOG_EXTRAS_ON_SEPARATE_LINES) ? ":" : "- ");
+
+        std::string_view copy(std::string_view source) {
+            char* destination = text + textSize;
+            std::memcpy(destination, source.data(), source.size());
+            textSize += source.size();
+            return std::string_view(destination, source.size());
         }
-        for (const std::string &extra : extras) {
-            *stringOutputStream << ((TINYLOG_EXTRAS_ON_SEPARATE_LINES) ? ("\n" + std::string(logLevelName.size() + 3, ' ') + "- ") : " ") << extra << " ;";
+    };
+
+    /// @brief The context of the current thread
+    inline static thread_local Arena arena{};
+
+    size_t previousFieldsCount;
+    size_t previousTextSize;
+};
+
+/**
+ * @brief A log, as handed to the outputs.
+ * @note Only holds views : the strings belong to the caller of `Logger::log()`, or to the asynchronous queue.
+ */
+struct LogRecord {
+    LogLevel logLevel;
+    LogClock::time_point timestamp;
+    bool showTimestamp;
+    std::string_view filePath;
+    int lineNumber;
+    std::string_view message;
+    const std::string_view* extras;
+    size_t extrasCount;
+    /// @brief The call site of the log, `nullptr` if it wasn't logged through the logging macros
+    const CallSite* callSite = nullptr;
+    const Field* fields = nullptr;
+    size_t fieldsCount = 0;
+    /// @brief The fields of the `LogContext` of the thread that logged
+    const Field* contextFields = nullptr;
+    size_t contextFieldsCount = 0;
+};
+
+/**
+ * @brief A growable character buffer logs are formatted into.
+ * @note Clearing it keeps its capacity, so a reused buffer stops allocating once it has grown to the size of the
+ *      longest log.
+ */
+class FormatBuffer {
+public:
+    /// @brief Empties the buffer, keeping its capacity
+    void clear() {
+        length = 0;
+    }
+
+    void append(char character) {
+        if (makeRoom(1) == 1)
+            storage[length++] = character;
+    }
+
+    void append(std::string_view text) {
+        size_t size = makeRoom(text.size());
+        std::memcpy(storage.get() + length, text.data(), size);
+        length += size;
+    }
+
+    /// @brief Appends `count` times the given character
+    void appendRepeated(char character, size_t count) {
+        count = makeRoom(count);
+        std::memset(storage.get() + length, character, count);
+        length += count;
+    }
+
+    /// @brief Inserts `count` times the given character at the given position, moving the rest of the buffer after them
+    void insertRepeated(size_t position, char character, size_t count) {
+        count = makeRoom(count);
+        std::memmove(storage.get() + position + count, storage.get() + position, length - position);
+        std::memset(storage.get() + position, character, count);
+        length += count;
+    }
+
+    /// @brief Appends the given integer as an unsigned LEB128 variable-length integer
+    void appendVarint(std::uint64_t value) {
+        if (makeRoom(10) < 10)
+            return;
+        while (value >= 0x80) {
+            storage[length++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
         }
-        *stringOutputStream << "\n";
+        storage[length++] = static_cast<char>(value);
+    }
+
+    /// @brief Appends the decimal representation of the given integer
+    void appendInteger(long long value) {
+        makeRoom(20);
+        appendConverted(std::to_chars(storage.get() + length, storage.get() + capacity, value));
+    }
+
+    /// @brief Appends the decimal representation of the given unsigned integer
+    void appendUnsignedInteger(unsigned long long value) {
+        makeRoom(20);
+        appendConverted(std::to_chars(storage.get() + length, storage.get() + capacity, value));
+    }
+
+    /// @brief Appends the shortest representation of the given number that reads back as the same number
+    void appendFloatingPoint(double value) {
+        makeRoom(32);
+        appendConverted(std::to_chars(storage.get() + length, storage.get() + capacity, value));
+    }
+
+    /// @brief Makes sure the buffer can hold `size` characters without growing
+    void reserve(size_t size) {
+        if (size <= capacity)
+            return;
+        size_t newCapacity = std::max<size_t>(capacity * 2, std::max<size_t>(size, 256));
+        std::unique_ptr<char[]> newStorage(new char[newCapacity]);
+        if (length > 0)
+            std::memcpy(newStorage.get(), storage.get(), length);
+        storage = std::move(newStorage);
+        capacity = newCapacity;
     }
 
     /**
-     * @brief Logs to the given outputs stream, as JSON
+     * @brief Makes sure the buffer can hold `size` characters, then stops it from growing : what no longer fits is
+     *      dropped, and the buffer never allocates again
      */
-    void logToJsonOutputStream(std::ostream *jsonOutputStream, LogLevel givenLogLevel, bool showTimestamp, std::string& filePath, int lineNumber, const std::string& message, std::vector<std::string>& extras) {
-        if (jsonOutputsCount > 0) {
-            *jsonOutputStream << ",";
-        }
-        *jsonOutputStream << "{\"severity\":\"" << getLogLevelName(givenLogLevel) << "\",";
-        *jsonOutputStream << "\"message\":\"" << message << "\",";
-        *jsonOutputStream << "\"timestamp\":\"" << getIso8601Timestamp() << "\"";
-        if (extras.size() > 0) {
-            *jsonOutputStream << ",\"extras\":[";
-            for (int i = 0; i < extras.size(); i++) {
-                *jsonOutputStream << "\"" << extras.at(i) << "\"";
-                if (i < extras.size() - 1) {
-                    *jsonOutputStream << ",";
-                }
-            }
-            *jsonOutputStream << "]";
+    void reserveFixed(size_t size) {
+        reserve(size);
+        isFixed = true;
+    }
+
+    /// @brief Returns whether the buffer is fixed and full, so that it dropped what was appended to it last
+    bool isFull() const {
+        return isFixed && length == capacity;
+    }
+
+    char* data() {
+        return storage.get();
+    }
+
+    const char* data() const {
+        return storage.get();
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    std::string_view view() const {
+        return std::string_view(storage.get(), length);
+    }
+
+private:
+    /// @brief Grows the buffer to hold `count` more characters, unless it is fixed ; returns how many of them it can hold
+    size_t makeRoom(size_t count) {
+        if (length + count > capacity) {
+            if (isFixed)
+                return capacity - length;
+            reserve(length + count);
         }
-        *jsonOutputStream << "}";
+        return count;
     }
-};
 
-#if TINYLOG_USE_NAMESPACE == 1
-}  // TinyLog
-#endif
+    /// @brief Keeps the characters written by `std::to_chars()`, unless they didn't fit in a fixed buffer
+    void appendConverted(std::to_chars_result result) {
+        if (result.ec == std::errc())
+            length = result.ptr - storage.get();
+    }
+
+    std::unique_ptr<char[]> storage;
+    size_t capacity = 0;
+    size_t length = 0;
+    bool isFixed = false;
+};
 
 /**
- * @brief Returns a string containing the given expression and its value
- * @param expression A C++ expression that can be converted to a string
- * @returns The string `"<EXPRESSION> = <VALUE>"` where `<EXPRESSION>` is the stringified `expression` parameter
- *      and `<VALUE>` is the value of said expression.
+ * @brief Something formatted logs are written to. Subclass it to log to a new kind of output.
+ * @note Writes to a sink are serialized by TinyLog : `write()` and `flush()` are never called concurrently.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief Writes formatted text to the sink
+     * @param data The text to write : a whole formatted log, or the framing of the output format (e.g. the brackets
+     *      around JSON logs).
+     * @param record The log `data` was formatted from, or `nullptr` if `data` is framing text.
+     */
+    virtual void write(std::string_view data, const LogRecord* record) = 0;
+
+    /**
+     * @brief Pushes any buffered data to its destination
+     */
+    virtual void flush() {}
+
+    /**
+     * @brief Writes any buffered data, then the given text, straight to the destination, when the process is crashing
+     * @param data Framing text or a formatted log to write after the buffered data ; may be empty
+     * @note Called by `Logger::emergencyFlush()`, possibly from a signal handler : it must only call async-signal-safe
+     *      functions, and neither allocate nor lock. Does nothing by default.
+     */
+    virtual void emergencyWrite(std::string_view data) {
+        (void)data;
+    }
+};
+
+/**
+ * @brief Which logs an output writes, on top of the current log level
+ * @note Converts from a log level : passing `TinyLog::ERROR` as filter only lets `ERROR` and `FATAL` logs through.
+ */
+struct OutputFilter {
+    OutputFilter() = default;
+    OutputFilter(LogLevel filterMinLogLevel, std::function<bool(const LogRecord&)> filterPredicate = {}) :
+        minLogLevel(filterMinLogLevel), predicate(std::move(filterPredicate)) {}
+
+    /// @brief The lowest log level the output writes
+    LogLevel minLogLevel = DEBUG;
+    /// @brief If set, the output only writes the logs it returns true for. Called from the thread writing the log.
+    std::function<bool(const LogRecord&)> predicate;
+
+    /// @brief Returns whether the given log passes this filter
+    bool accepts(const LogRecord& record) const {
+        return static_cast<char>(record.logLevel) >= static_cast<char>(minLogLevel) && (!predicate || predicate(record));
+    }
+};
+
+/**
+ * @brief The layout of the logs of a string output, compiled once from a pattern such as `%t %L %f:%l %m`.
+ * @note The pattern is parsed into a sequence of segments when the layout is created : formatting a log only walks
+ *      through them, with no parsing. Specifiers :
+ *      - `%t` : the timestamp, `2025-11-17T12:00:00Z`, with the precision of `Logger::setTimestampPrecision()`
+ *      - `%L` : the log level, `INFO`
+ *      - `%f` : the file path, `%l` : the line number ; empty if unknown
+ *      - `%m` : the message
+ *      - `%e` : the extras and the fields of the log, `First extra ; count = 5 ;`, on one line ; not the fields of
+ *        the `LogContext`
+ *      - `%E` : the same, laid out as the built-in layout does : each on its own line if
+ *        `TINYLOG_EXTRAS_ON_SEPARATE_LINES` is 1, on one line otherwise
+ *      - `%X` : only the fields of the `LogContext`, `requestId = 42 ;`
+ *      - `%n` : a newline, `%%` : a percent sign
+ *      A width pads the value with spaces, e.g. `%5L` on the left, and `%-5L` on the right. Each log ends with a newline.
+ */
+class PatternLayout {
+public:
+    /// @brief The built-in layout, `[INFO ] 2025-11-17T12:00:00Z - main.cpp (line 42) - Message - EXTRAS - Extra ;`,
+    ///     the fields of the `LogContext` being listed along with the extras
+    PatternLayout() = default;
+
+    /**
+     * @brief Compiles the given pattern
+     * @note Unknown specifiers are written as they are, and make `isValid()` return false.
+     */
+    PatternLayout(std::string_view layoutPattern) : pattern(layoutPattern), isDefaultLayout(false) {
+        for (size_t i = 0; i < pattern.size(); i++) {
+            if (pattern[i] != '%' || i + 1 == pattern.size()) {
+                isValidPattern = isValidPattern && pattern[i] != '%';
+                appendLiteral(pattern[i]);
+                continue;
+            }
+            size_t specifierStart = i++;
+            bool isLeftAligned = pattern[i] == '-';
+            if (isLeftAligned)
+                i++;
+            size_t width = 0;
+            while (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') {
+                width = width * 10 + static_cast<size_t>(pattern[i++] - '0');
+            }
+            Token token = Token::LITERAL;
+            switch (i < pattern.size() ? pattern[i] : '\0') {
+                case 't': token = Token::TIMESTAMP; break;
+                case 'L': token = Token::LOG_LEVEL; break;
+                case 'f': token = Token::FILE_PATH; break;
+                case 'l': token = Token::LINE_NUMBER; break;
+                case 'm': token = Token::MESSAGE; break;
+                case 'e': token = Token::EXTRAS; break;
+                case 'E': token = Token::EXTRAS_ON_SEPARATE_LINES; break;
+                case 'X': token = Token::CONTEXT; break;
+                case 'n': appendLiteral('\n'); continue;
+                case '%': appendLiteral('%'); continue;
+                default:
+                    isValidPattern = false;
+                    for (size_t j = specifierStart; j <= i && j < pattern.size(); j++) {
+                        appendLiteral(pattern[j]);
+                    }
+                    continue;
+            }
+            segments.push_back({token, width, isLeftAligned, 0, 0});
+        }
+        appendLiteral('\n');
+    }
+
+    /// @brief Compiles the given pattern
+    PatternLayout(const char* layoutPattern) : PatternLayout(std::string_view(layoutPattern)) {}
+
+    /// @brief Returns whether this is the built-in layout
+    bool isDefault() const {
+        return isDefaultLayout;
+    }
+
+    /// @brief Returns whether every specifier of the pattern is known
+    bool isValid() const {
+        return isValidPattern;
+    }
+
+    /// @brief Returns the pattern this layout was compiled from, empty for the built-in layout
+    const std::string& getPattern() const {
+        return pattern;
+    }
+
+private:
+    friend class Logger;
+
+    enum class Token: char {
+        LITERAL = 0,
+        TIMESTAMP,
+        LOG_LEVEL,
+        FILE_PATH,
+        LINE_NUMBER,
+        MESSAGE,
+        EXTRAS,
+        EXTRAS_ON_SEPARATE_LINES,
+        CONTEXT
+    };
+
+    /// @brief A part of the layout : a value of the log, or literal text
+    struct Segment {
+        Token token;
+        /// @brief The minimal width of the value, padded with spaces
+        size_t width;
+        bool isLeftAligned;
+        /// @brief The position of the text of a literal in `literals`
+        size_t literalOffset;
+        size_t literalSize;
+    };
+
+    /// @brief Appends a character to the literal text at the end of the layout
+    void appendLiteral(char character) {
+        if (segments.empty() || segments.back().token != Token::LITERAL)
+            segments.push_back({Token::LITERAL, 0, false, literals.size(), 0});
+        literals.push_back(character);
+        segments.back().literalSize++;
+    }
+
+    std::string pattern;
+    /// @brief The text of every literal, one after the other
+    std::string literals;
+    std::vector<Segment> segments;
+    bool isDefaultLayout = true;
+    bool isValidPattern = true;
+};
+
+/**
+ * @brief A snapshot of the counters TinyLog keeps about itself, see `Logger::getMetrics()`
+ * @note Counts are cumulative since the start of the program.
+ */
+struct LogMetrics {
+    /// @brief How many log levels are counted, from `DEBUG` to `FATAL`
+    static constexpr size_t logLevelsCount = static_cast<size_t>(FATAL) + 1;
+
+    /// @brief The counters of an enabled output
+    struct OutputMetrics {
+        /// @brief `string`, `json` or `binary`
+        std::string_view format;
+        const Sink* sink;
+        /// @brief How many logs were written to the sink
+        long long logsCount;
+        /// @brief How many bytes of formatted logs were written to the sink ; binary sinks encode the logs themselves, and report 0
+        long long bytesCount;
+    };
+
+    /// @brief How many logs were handed to the outputs, by log level
+    long long emittedCounts[logLevelsCount] = {};
+    /// @brief How many logs were discarded because of their level, by log level
+    long long filteredCounts[logLevelsCount] = {};
+    /// @brief How many logs were discarded by the overflow policy of the asynchronous mode
+    long long droppedCount = 0;
+    /// @brief How many times the outputs were flushed
+    long long flushesCount = 0;
+    /// @brief How many logs the asynchronous queue holds, 0 if the asynchronous mode is disabled
+    size_t queueDepth = 0;
+    /// @brief The most logs the asynchronous queue held, as seen by the writer thread, since the asynchronous mode was enabled
+    size_t queueHighWaterMark = 0;
+    /// @brief Time spent formatting the logs, and writing them to the sinks
+    /// @note Estimated from one log out of `TINYLOG_METRICS_TIMING_PERIOD`.
+    std::chrono::nanoseconds formattingTime{0};
+    std::chrono::nanoseconds writingTime{0};
+    std::vector<OutputMetrics> outputs;
+
+    /**
+     * @brief Returns the metrics in the Prometheus text exposition format
+     * @param prefix The prefix of the names of the metrics
+     */
+    std::string toPrometheus(std::string_view prefix = "tinylog") const {
+        std::string text;
+        auto appendHeader = [&](std::string_view name, std::string_view type, std::string_view help) {
+            text.append("# HELP ").append(prefix).append(name).append(" ").append(help).append("\n");
+            text.append("# TYPE ").append(prefix).append(name).append(" ").append(type).append("\n");
+        };
+        auto appendValue = [&](std::string_view name, std::string_view labels, auto value) {
+            text.append(prefix).append(name);
+            if (!labels.empty())
+                text.append("{").append(labels).append("}");
+            text.append(" ").append(std::to_string(value)).append("\n");
+        };
+
+        appendHeader("_logs_emitted_total", "counter", "Logs handed to the outputs.");
+        for (size_t i = 0; i < logLevelsCount; i++) {
+            appendValue("_logs_emitted_total", "level=\"" + std::string(getLogLevelName(static_cast<LogLevel>(i))) + "\"", emittedCounts[i]);
+        }
+        appendHeader("_logs_filtered_total", "counter", "Logs discarded because of their level.");
+        for (size_t i = 0; i < logLevelsCount; i++) {
+            appendValue("_logs_filtered_total", "level=\"" + std::string(getLogLevelName(static_cast<LogLevel>(i))) + "\"", filteredCounts[i]);
+        }
+        appendHeader("_logs_dropped_total", "counter", "Logs discarded by the overflow policy of the asynchronous queue.");
+        appendValue("_logs_dropped_total", "", droppedCount);
+        appendHeader("_flushes_total", "counter", "Flushes of the outputs.");
+        appendValue("_flushes_total", "", flushesCount);
+        appendHeader("_queue_depth", "gauge", "Logs held by the asynchronous queue.");
+        appendValue("_queue_depth", "", queueDepth);
+        appendHeader("_queue_high_water_mark", "gauge", "Most logs held by the asynchronous queue.");
+        appendValue("_queue_high_water_mark", "", queueHighWaterMark);
+        appendHeader("_formatting_seconds_total", "counter", "Time spent formatting the logs.");
+        appendValue("_formatting_seconds_total", "", std::chrono::duration<double>(formattingTime).count());
+        appendHeader("_writing_seconds_total", "counter", "Time spent writing the logs to the sinks.");
+        appendValue("_writing_seconds_total", "", std::chrono::duration<double>(writingTime).count());
+
+        appendHeader("_output_logs_total", "counter", "Logs written to each output.");
+        std::vector<std::string> outputLabels;
+        size_t formatIndex = 0;
+        for (size_t i = 0; i < outputs.size(); i++) {
+            formatIndex = (i > 0 && outputs[i].format == outputs[i - 1].format) ? formatIndex + 1 : 0;
+            outputLabels.push_back("format=\"" + std::string(outputs[i].format) + "\",output=\"" + std::to_string(formatIndex) + "\"");
+            appendValue("_output_logs_total", outputLabels.back(), outputs[i].logsCount);
+        }
+        appendHeader("_output_bytes_total", "counter", "Bytes of formatted logs written to each output.");
+        for (size_t i = 0; i < outputs.size(); i++) {
+            appendValue("_output_bytes_total", outputLabels[i], outputs[i].bytesCount);
+        }
+        return text;
+    }
+};
+
+/**
+ * @brief A sink writing to an `std::ostream`
+ * @note Left out of the crash handler : the buffer of a stream can't be written from a signal handler, as it may
+ *      allocate, lock, or be half-updated by the interrupted thread. Use a `FileSink` for the logs that must survive a
+ *      crash.
+ */
+class OstreamSink : public Sink {
+public:
+    explicit OstreamSink(std::ostream& outputStream) : stream(outputStream) {}
+
+    void write(std::string_view data, const LogRecord*) override {
+        stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    void flush() override {
+        stream.flush();
+    }
+
+private:
+    std::ostream& stream;
+};
+
+/**
+ * @brief The settings of a `BatchingSink`
+ */
+struct BatchingSinkOptions {
+    /// @brief Size, in bytes, from which the batch is written to the destination
+    size_t maxBatchSize = TINYLOG_BATCH_DEFAULT_SIZE;
+    /// @brief Maximal time a log waits in the batch before a timer thread writes it. 0 disables the timer thread.
+    std::chrono::milliseconds maxLatency{50};
+    /// @brief Logs of this level or above are written and flushed right away, along with the rest of the batch
+    LogLevel flushLogLevel = ERROR;
+};
+
+/**
+ * @brief A sink accumulating logs into batches, written to another sink in a single `write()` call.
+ * @note A batch is written once it reaches `maxBatchSize`, once its oldest log is `maxLatency` old, along with a log
+ *      of at least `flushLogLevel`, or when TinyLog flushes its outputs.
+ * @warning The destination is written from the timer thread too : it must not be an output of its own.
+ */
+class BatchingSink : public Sink {
+public:
+    /**
+     * @brief Batches the logs written to the given sink
+     * @param destinationSink The sink the batches are written to. Must outlive this sink.
+     * @param options The settings of the sink.
+     */
+    explicit BatchingSink(Sink& destinationSink, BatchingSinkOptions options = {}) : destination(&destinationSink), options(options) {
+        start();
+    }
+
+    /**
+     * @brief Batches the logs written to the given stream
+     * @param outputStream The stream the batches are written to. Must outlive this sink.
+     * @param options The settings of the sink.
+     */
+    explicit BatchingSink(std::ostream& outputStream, BatchingSinkOptions options = {}) :
+        ownedDestination(std::make_unique<OstreamSink>(outputStream)), destination(ownedDestination.get()), options(options) {
+        start();
+    }
+
+    BatchingSink(const BatchingSink&) = delete;
+    BatchingSink& operator=(const BatchingSink&) = delete;
+
+    ~BatchingSink() override {
+        {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            isStopping = true;
+        }
+        timerCondition.notify_one();
+        if (timerThread.joinable())
+            timerThread.join();
+        flush();
+    }
+
+    void write(std::string_view data, const LogRecord* record) override {
+        std::unique_lock<std::mutex> lock(batchMutex);
+        if (!startChangingBatch())
+            return;
+        bool wasEmpty = batch.size() == 0;
+        if (wasEmpty)
+            oldestLogTime = std::chrono::steady_clock::now();
+        batch.append(data);
+
+        bool isTimerNeeded = false;
+        if (record != nullptr && static_cast<char>(record->logLevel) >= static_cast<char>(options.flushLogLevel)) {
+            writeBatch();
+            destination->flush();
+        } else if (batch.size() >= options.maxBatchSize) {
+            writeBatch();
+        } else {
+            isTimerNeeded = wasEmpty && timerThread.joinable();
+        }
+        stopChangingBatch();
+        if (isTimerNeeded) {
+            lock.unlock();
+            timerCondition.notify_one();
+        }
+    }
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        if (!startChangingBatch())
+            return;
+        writeBatch();
+        destination->flush();
+        stopChangingBatch();
+    }
+
+    /**
+     * @note The batch is skipped if the crash interrupted a thread changing it. Otherwise, it is kept taken over : no
+     *      other thread changes it anymore.
+     */
+    void emergencyWrite(std::string_view data) override {
+        if (startChangingBatch()) {
+            destination->emergencyWrite(batch.view());
+            batch.clear();
+        }
+        destination->emergencyWrite(data);
+    }
+
+    /// @brief Returns how many batches were written to the destination
+    long long getFlushesCount() const {
+        return flushesCount.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns how many bytes were written to the destination
+    long long getWrittenBytesCount() const {
+        return writtenBytesCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief Starts the timer thread, if the batches have a maximal latency
+    void start() {
+        batch.reserve(options.maxBatchSize);
+        if (options.maxLatency.count() > 0)
+            timerThread = std::thread([this]() { runTimer(); });
+    }
+
+    /**
+     * @brief Writes the batch to the destination, if it isn't empty
+     * @warning `batchMutex` must be held.
+     */
+    void writeBatch() {
+        if (batch.size() == 0)
+            return;
+        destination->write(batch.view(), nullptr);
+        flushesCount.fetch_add(1, std::memory_order_relaxed);
+        writtenBytesCount.fetch_add(static_cast<long long>(batch.size()), std::memory_order_relaxed);
+        batch.clear();
+    }
+
+    /// @brief Waits for the oldest log of each batch to be `maxLatency` old, and writes the batch if it is still pending
+    void runTimer() {
+        std::unique_lock<std::mutex> lock(batchMutex);
+        while (!isStopping) {
+            if (batch.size() == 0) {
+                timerCondition.wait(lock);
+                continue;
+            }
+            std::chrono::steady_clock::time_point deadline = oldestLogTime + options.maxLatency;
+            if (std::chrono::steady_clock::now() < deadline) {
+                timerCondition.wait_until(lock, deadline);
+                continue;
+            }
+            if (!startChangingBatch())
+                return;
+            writeBatch();
+            destination->flush();
+            stopChangingBatch();
+        }
+    }
+
+    /**
+     * @brief Marks the batch as being changed, so that the crash handler skips it rather than waiting for `batchMutex`
+     * @returns False if the batch is being changed, or was taken over by the crash handler.
+     */
+    bool startChangingBatch() {
+        return !isBatchChanging.exchange(true, std::memory_order_acquire);
+    }
+
+    void stopChangingBatch() {
+        isBatchChanging.store(false, std::memory_order_release);
+    }
+
+    std::unique_ptr<Sink> ownedDestination;
+    Sink* destination;
+    BatchingSinkOptions options;
+
+    /// @brief Held while the batch is changed or written, by TinyLog and by the timer thread
+    std::mutex batchMutex;
+    /// @brief Set while the batch is changed or written, under `batchMutex` ; left set once the crash handler took it over
+    std::atomic<bool> isBatchChanging{false};
+    FormatBuffer batch;
+    /// @brief When the oldest log of the batch was written to this sink
+    std::chrono::steady_clock::time_point oldestLogTime;
+    bool isStopping = false;
+    std::condition_variable timerCondition;
+    std::thread timerThread;
+
+    std::atomic<long long> flushesCount{0};
+    std::atomic<long long> writtenBytesCount{0};
+};
+
+/**
+ * @brief The header of the file of a `RingFileSink`, at its start. The entries follow, from `RingFileHeader::dataOffset`.
+ * @note Each entry is what the sink was given to write, prefixed with its size as a native 32-bits integer. Entries are
+ *      written one after the other, wrapping around at the end of the data, and overwriting the oldest ones.
+ */
+struct RingFileHeader {
+    static constexpr std::string_view magic = std::string_view("TLOGRING", 8);
+    static constexpr std::uint32_t currentVersion = 1;
+    /// @brief Offset of the data in the file, aligned on pages
+    static constexpr size_t dataOffset = 4096;
+
+    char fileMagic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    /// @brief Size, in bytes, of the data following the header
+    std::uint64_t capacity;
+    /// @brief How many bytes have been written since the ring was created ; the next entry starts at `writePosition % capacity`
+    std::uint64_t writePosition;
+    /// @brief Position, in the same unit as `writePosition`, of the oldest entry that hasn't been overwritten
+    std::uint64_t oldestPosition;
+};
+
+#if TINYLOG_HAS_POSIX == 1
+/**
+ * @brief When a `FileSink` asks the system to persist the written logs to the disk
+ */
+enum class FileSyncPolicy: char {
+    /// @brief Never : the system persists the logs whenever it wants
+    NEVER = 0,
+    /// @brief When a log is written at least `FileSinkOptions::syncInterval` after the previous persist
+    INTERVAL,
+    /// @brief Every time an `ERROR` or `FATAL` log is written
+    ON_ERROR
+};
+
+/**
+ * @brief The settings of a `FileSink`
+ */
+struct FileSinkOptions {
+    /// @brief Size of the buffer logs are accumulated into before being written to the file
+    size_t bufferSize = TINYLOG_FILE_SINK_BUFFER_SIZE;
+    /// @brief When to persist the logs to the disk
+    FileSyncPolicy syncPolicy = FileSyncPolicy::NEVER;
+    /// @brief Minimal time between two persists, with the `FileSyncPolicy::INTERVAL` policy
+    std::chrono::milliseconds syncInterval{1000};
+    /// @brief If true, appends to the file instead of truncating it
+    bool append = true;
+    /// @brief If true, bypasses the page cache (`O_DIRECT`) when the system supports it
+    /// @note Only whole blocks are then written before the sink is destroyed : `flush()` keeps the last partial block buffered.
+    bool useDirectIo = false;
+};
+
+/**
+ * @brief A sink writing directly to a file descriptor, bypassing iostreams.
+ * @note Logs are accumulated into a large aligned buffer, written with as few `write(2)`/`writev(2)` calls as possible.
+ */
+class FileSink : public Sink {
+public:
+    /// @brief Alignment of the buffer, compatible with direct I/O
+    static constexpr size_t bufferAlignment = 4096;
+
+    /**
+     * @brief Opens the given file
+     * @param path The path of the file to log to. Created if it doesn't exist.
+     * @param options The settings of the sink.
+     * @note If the file can't be opened, `isOpen()` returns false and every log is discarded.
+     */
+    explicit FileSink(const std::string& path, FileSinkOptions options = {}) : options(options) {
+        size_t alignedSize = std::max(bufferAlignment, (options.bufferSize + bufferAlignment - 1) / bufferAlignment * bufferAlignment);
+        void* memory = nullptr;
+        if (posix_memalign(&memory, bufferAlignment, alignedSize) != 0)
+            return;
+        buffer = static_cast<char*>(memory);
+        bufferCapacity = alignedSize;
+
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (options.append ? O_APPEND : O_TRUNC);
+#ifdef O_DIRECT
+        if (options.useDirectIo) {
+            fileDescriptor = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            struct stat fileStatus{};
+            if (fileDescriptor >= 0 && fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size % bufferAlignment == 0) {
+                isDirectIo = true;
+                lastSync = LogClock::now();
+                return;
+            }
+            // Unsupported by the file system, or existing content not aligned : falls back to buffered I/O
+            if (fileDescriptor >= 0)
+                ::close(fileDescriptor);
+        }
+#endif
+        fileDescriptor = ::open(path.c_str(), flags, 0644);
+        lastSync = LogClock::now();
+    }
+
+    ~FileSink() override {
+        if (fileDescriptor >= 0) {
+            if (isDirectIo) {
+                writeBuffer();
+                disableDirectIo();
+            }
+            writeBuffer();
+            if (options.syncPolicy != FileSyncPolicy::NEVER)
+                sync();
+            ::close(fileDescriptor);
+        }
+        std::free(buffer);
+    }
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    /// @brief Returns whether the file was successfully opened
+    bool isOpen() const {
+        return fileDescriptor >= 0;
+    }
+
+    void write(std::string_view data, const LogRecord* record) override {
+        if (fileDescriptor < 0)
+            return;
+
+        if (bufferedSize + data.size() <= bufferCapacity) {
+            std::memcpy(buffer + bufferedSize, data.data(), data.size());
+            bufferedSize += data.size();
+        } else if (!isDirectIo) {
+            // Writes the buffer and the new data in a single call
+            struct iovec parts[2] = {{buffer, bufferedSize}, {const_cast<char*>(data.data()), data.size()}};
+            writeAll(parts, 2);
+            bufferedSize = 0;
+        } else {
+            while (!data.empty()) {
+                size_t copiedSize = std::min(data.size(), bufferCapacity - bufferedSize);
+                std::memcpy(buffer + bufferedSize, data.data(), copiedSize);
+                bufferedSize += copiedSize;
+                data.remove_prefix(copiedSize);
+                if (bufferedSize == bufferCapacity)
+                    writeBuffer();
+            }
+        }
+
+        if (record == nullptr)
+            return;
+        if (options.syncPolicy == FileSyncPolicy::ON_ERROR && static_cast<char>(record->logLevel) >= static_cast<char>(ERROR)) {
+            flush();
+            sync();
+        } else if (options.syncPolicy == FileSyncPolicy::INTERVAL && record->timestamp - lastSync >= options.syncInterval) {
+            flush();
+            sync();
+        }
+    }
+
+    void flush() override {
+        if (fileDescriptor >= 0)
+            writeBuffer();
+    }
+
+    void emergencyWrite(std::string_view data) override {
+        if (fileDescriptor < 0)
+            return;
+        // The last partial block can only be written without direct I/O
+        if (isDirectIo)
+            disableDirectIo();
+        struct iovec parts[2] = {{buffer, bufferedSize}, {const_cast<char*>(data.data()), data.size()}};
+        writeAll(parts, 2);
+        bufferedSize = 0;
+        if (options.syncPolicy != FileSyncPolicy::NEVER)
+            ::fsync(fileDescriptor);
+    }
+
+    /**
+     * @brief Asks the system to persist everything written so far to the disk
+     * @note Does not write the buffer, see `flush()`.
+     */
+    void sync() {
+        if (fileDescriptor < 0)
+            return;
+#ifdef __linux__
+        fdatasync(fileDescriptor);
+#else
+        fsync(fileDescriptor);
+#endif
+        lastSync = LogClock::now();
+    }
+
+private:
+    /**
+     * @brief Writes the buffer to the file. With direct I/O, only whole blocks are written, the rest stays buffered.
+     */
+    void writeBuffer() {
+        size_t writtenSize = isDirectIo ? bufferedSize / bufferAlignment * bufferAlignment : bufferedSize;
+        if (writtenSize == 0)
+            return;
+        struct iovec part = {buffer, writtenSize};
+        writeAll(&part, 1);
+        std::memmove(buffer, buffer + writtenSize, bufferedSize - writtenSize);
+        bufferedSize -= writtenSize;
+    }
+
+    /**
+     * @brief Writes every given part, retrying on partial writes and interruptions.
+     * @note Data that can't be written (e.g. full disk) is discarded.
+     */
+    void writeAll(struct iovec* parts, int partsCount) {
+        while (partsCount > 0) {
+            ssize_t writtenSize = ::writev(fileDescriptor, parts, partsCount);
+            if (writtenSize < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            while (partsCount > 0 && static_cast<size_t>(writtenSize) >= parts->iov_len) {
+                writtenSize -= parts->iov_len;
+                parts++;
+                partsCount--;
+            }
+            if (partsCount > 0) {
+                parts->iov_base = static_cast<char*>(parts->iov_base) + writtenSize;
+                parts->iov_len -= writtenSize;
+            }
+        }
+    }
+
+    void disableDirectIo() {
+#ifdef O_DIRECT
+        fcntl(fileDescriptor, F_SETFL, fcntl(fileDescriptor, F_GETFL) & ~O_DIRECT);
+#endif
+        isDirectIo = false;
+    }
+
+    FileSinkOptions options;
+    int fileDescriptor = -1;
+    bool isDirectIo = false;
+    char* buffer = nullptr;
+    size_t bufferCapacity = 0;
+    size_t bufferedSize = 0;
+    LogClock::time_point lastSync{};
+};
+
+/**
+ * @brief How a `RollingFileSink` compresses its archives
+ */
+enum class RollingCompression: char {
+    /// @brief Archives are left as they are
+    NONE = 0,
+    /// @brief `.gz` archives ; requires `TINYLOG_USE_ZLIB` set to 1, and linking zlib
+    GZIP,
+    /// @brief `.zst` archives ; requires `TINYLOG_USE_ZSTD` set to 1, and linking libzstd
+    ZSTD
+};
+
+/**
+ * @brief The settings of a `RollingFileSink`
+ */
+struct RollingFileSinkOptions {
+    /// @brief Size, in bytes, above which the file is rotated ; 0 to never rotate based on the size
+    size_t maxFileSize = TINYLOG_ROLLING_FILE_DEFAULT_MAX_SIZE;
+    /// @brief Interval between two rotations, aligned on the epoch (e.g. 24 hours rotates at midnight UTC) ; 0 to never
+    ///     rotate based on the time
+    std::chrono::seconds rotationInterval{0};
+    /// @brief How many archives are kept : `path.1` (the most recent) to `path.<maxArchives>`
+    int maxArchives = 5;
+    /// @brief How the archives are compressed ; left uncompressed if TinyLog was built without support for it
+    RollingCompression compression = RollingCompression::NONE;
+    /// @brief The settings of the file being written
+    FileSinkOptions fileOptions;
+};
+
+/**
+ * @brief A sink writing to a file, rotated once it reaches a given size or at a given interval.
+ * @note On rotation, the file is closed and renamed, then a new one is opened under the same path. A background thread
+ *      then shifts the archives, compresses the closed file into `path.1` and removes the archives beyond
+ *      `maxArchives`, so that the logging thread never waits for them.
+ * @note Files are only rotated between two logs. JSON `ARRAY` outputs would then be split into invalid files : use
+ *      string or `JsonFormat::NDJSON` outputs with it.
+ */
+class RollingFileSink : public Sink {
+public:
+    /**
+     * @param filePath The path of the file to log to.
+     * @param options The settings of the sink.
+     * @note If the file can't be opened, `isOpen()` returns false and every log is discarded until the next rotation.
+     */
+    explicit RollingFileSink(const std::string& filePath, RollingFileSinkOptions options = {}) : path(filePath), options(options) {
+        if (!isCompressionSupported(options.compression))
+            this->options.compression = RollingCompression::NONE;
+        openFile();
+        nextRotation = getNextRotation(LogClock::now());
+    }
+
+    /// @brief Closes the file, and waits for the pending archives to be compressed
+    ~RollingFileSink() override {
+        file.reset();
+        {
+            std::lock_guard<std::mutex> lock(archiveMutex);
+            isStopping = true;
+        }
+        archiveCondition.notify_one();
+        if (archiveThread.joinable())
+            archiveThread.join();
+    }
+
+    RollingFileSink(const RollingFileSink&) = delete;
+    RollingFileSink& operator=(const RollingFileSink&) = delete;
+
+    /// @brief Returns whether TinyLog was built with support for the given compression
+    static constexpr bool isCompressionSupported(RollingCompression compression) {
+        return compression == RollingCompression::NONE
+            || (compression == RollingCompression::GZIP && TINYLOG_USE_ZLIB == 1)
+            || (compression == RollingCompression::ZSTD && TINYLOG_USE_ZSTD == 1);
+    }
+
+    /// @brief Returns whether the current file was successfully opened
+    bool isOpen() const {
+        return file != nullptr && file->isOpen();
+    }
+
+    void write(std::string_view data, const LogRecord* record) override {
+        if (record != nullptr && fileSize > 0) {
+            bool isFull = options.maxFileSize > 0 && fileSize + data.size() > options.maxFileSize;
+            if (isFull || record->timestamp >= nextRotation)
+                rotate(record->timestamp);
+        }
+        file->write(data, record);
+        fileSize += data.size();
+    }
+
+    void flush() override {
+        file->flush();
+    }
+
+    void emergencyWrite(std::string_view data) override {
+        file->emergencyWrite(data);
+    }
+
+    /**
+     * @brief Waits until every closed file has been archived
+     */
+    void waitForArchives() {
+        std::unique_lock<std::mutex> lock(archiveMutex);
+        archivedCondition.wait(lock, [this]() { return pendingFiles.empty() && !isArchiving; });
+    }
+
+private:
+    void openFile() {
+        struct stat fileStatus{};
+        fileSize = (options.fileOptions.append && ::stat(path.c_str(), &fileStatus) == 0) ? static_cast<size_t>(fileStatus.st_size) : 0;
+        file = std::make_unique<FileSink>(path, options.fileOptions);
+    }
+
+    /// @brief Returns the first rotation boundary after the given time
+    LogClock::time_point getNextRotation(LogClock::time_point time) const {
+        if (options.rotationInterval.count() <= 0)
+            return LogClock::time_point::max();
+        auto interval = std::chrono::duration_cast<LogClock::duration>(options.rotationInterval);
+        return LogClock::time_point((time.time_since_epoch() / interval + 1) * interval);
+    }
+
+    /**
+     * @brief Closes the file, renames it so that the next file can take its path, and hands it to the archive thread
+     */
+    void rotate(LogClock::time_point time) {
+        file.reset();
+        std::string closedPath = path + ".closed." + std::to_string(++rotationsCount);
+        bool isRenamed = std::rename(path.c_str(), closedPath.c_str()) == 0;
+        options.fileOptions.append = true;  // Only the first file may truncate an existing file
+        openFile();
+        nextRotation = getNextRotation(time);
+        if (!isRenamed)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(archiveMutex);
+            pendingFiles.push_back(std::move(closedPath));
+            if (!archiveThread.joinable())
+                archiveThread = std::thread(&RollingFileSink::runArchiver, this);
+        }
+        archiveCondition.notify_one();
+    }
+
+    /**
+     * @brief Returns the path of the given archive
+     * @param isCompressed False for the name of an archive left uncompressed because its compression failed
+     */
+    std::string getArchivePath(int index, bool isCompressed = true) const {
+        static constexpr const char* extensions[] = {"", ".gz", ".zst"};
+        return path + "." + std::to_string(index) + (isCompressed ? extensions[static_cast<int>(options.compression)] : "");
+    }
+
+    void runArchiver() {
+        std::unique_lock<std::mutex> lock(archiveMutex);
+        while (true) {
+            archiveCondition.wait(lock, [this]() { return !pendingFiles.empty() || isStopping; });
+            if (pendingFiles.empty())
+                return;
+            std::string closedPath = std::move(pendingFiles.front());
+            pendingFiles.pop_front();
+            isArchiving = true;
+            lock.unlock();
+            archive(closedPath);
+            lock.lock();
+            isArchiving = false;
+            archivedCondition.notify_all();
+        }
+    }
+
+    /**
+     * @brief Shifts the archives, removes the oldest one, then moves the given closed file to `path.1`
+     * @note Archives left uncompressed, under `path.<index>`, are shifted and removed along with the compressed ones.
+     */
+    void archive(const std::string& closedPath) {
+        if (options.maxArchives <= 0) {
+            std::remove(closedPath.c_str());
+            return;
+        }
+        bool hasUncompressedArchives = options.compression != RollingCompression::NONE;
+        std::remove(getArchivePath(options.maxArchives).c_str());
+        if (hasUncompressedArchives)
+            std::remove(getArchivePath(options.maxArchives, false).c_str());
+        for (int index = options.maxArchives - 1; index >= 1; index--) {
+            std::rename(getArchivePath(index).c_str(), getArchivePath(index + 1).c_str());
+            if (hasUncompressedArchives)
+                std::rename(getArchivePath(index, false).c_str(), getArchivePath(index + 1, false).c_str());
+        }
+
+        std::string archivePath = getArchivePath(1);
+        if (options.compression == RollingCompression::NONE) {
+            std::rename(closedPath.c_str(), archivePath.c_str());
+            return;
+        }
+        // Compresses to a temporary file first, so that a partial archive never takes the place of a complete one
+        std::string temporaryPath = archivePath + ".tmp";
+        if (compress(closedPath, temporaryPath) && std::rename(temporaryPath.c_str(), archivePath.c_str()) == 0) {
+            std::remove(closedPath.c_str());
+        } else {
+            // Keeps the logs uncompressed rather than losing them
+            std::remove(temporaryPath.c_str());
+            std::rename(closedPath.c_str(), getArchivePath(1, false).c_str());
+        }
+    }
+
+    /// @brief Compresses the given file, returns whether it succeeded
+    bool compress(const std::string& sourcePath, const std::string& destinationPath) {
+        int source = ::open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (source < 0)
+            return false;
+        bool isCompressed = false;
+#if TINYLOG_USE_ZLIB == 1
+        if (options.compression == RollingCompression::GZIP)
+            isCompressed = compressWithZlib(source, destinationPath);
+#endif
+#if TINYLOG_USE_ZSTD == 1
+        if (options.compression == RollingCompression::ZSTD)
+            isCompressed = compressWithZstd(source, destinationPath);
+#endif
+        ::close(source);
+        (void) destinationPath;
+        return isCompressed;
+    }
+
+    /// @brief Reads from the given file descriptor, retrying on interruptions ; returns -1 on errors
+    static ssize_t readSome(int fileDescriptor, char* data, size_t size) {
+        ssize_t readSize;
+        do {
+            readSize = ::read(fileDescriptor, data, size);
+        } while (readSize < 0 && errno == EINTR);
+        return readSize;
+    }
+
+#if TINYLOG_USE_ZLIB == 1
+    static bool compressWithZlib(int source, const std::string& destinationPath) {
+        gzFile destination = gzopen(destinationPath.c_str(), "wb6");
+        if (destination == nullptr)
+            return false;
+        std::vector<char> chunk(TINYLOG_FILE_SINK_BUFFER_SIZE);
+        ssize_t readSize;
+        bool isCompressed = true;
+        while (isCompressed && (readSize = readSome(source, chunk.data(), chunk.size())) > 0) {
+            isCompressed = gzwrite(destination, chunk.data(), static_cast<unsigned int>(readSize)) == readSize;
+        }
+        return gzclose(destination) == Z_OK && isCompressed && readSize == 0;
+    }
+#endif
+
+#if TINYLOG_USE_ZSTD == 1
+    static bool compressWithZstd(int source, const std::string& destinationPath) {
+        FileSinkOptions destinationOptions;
+        destinationOptions.append = false;
+        FileSink destination(destinationPath, destinationOptions);
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        if (!destination.isOpen() || context == nullptr) {
+            ZSTD_freeCCtx(context);
+            return false;
+        }
+        std::vector<char> input(ZSTD_CStreamInSize());
+        std::vector<char> output(ZSTD_CStreamOutSize());
+        bool isCompressed = true;
+        bool isLastChunk = false;
+        while (isCompressed && !isLastChunk) {
+            ssize_t readSize = readSome(source, input.data(), input.size());
+            if (readSize < 0)
+                break;
+            isLastChunk = readSize == 0;
+            ZSTD_inBuffer inputBuffer = {input.data(), static_cast<size_t>(readSize), 0};
+            bool isChunkDone = false;
+            while (!isChunkDone) {
+                ZSTD_outBuffer outputBuffer = {output.data(), output.size(), 0};
+                size_t remaining = ZSTD_compressStream2(context, &outputBuffer, &inputBuffer, isLastChunk ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(remaining)) {
+                    isCompressed = false;
+                    break;
+                }
+                destination.write(std::string_view(output.data(), outputBuffer.pos), nullptr);
+                isChunkDone = isLastChunk ? remaining == 0 : inputBuffer.pos == inputBuffer.size;
+            }
+        }
+        ZSTD_freeCCtx(context);
+        return isCompressed && isLastChunk;
+    }
+#endif
+
+    std::string path;
+    RollingFileSinkOptions options;
+    std::unique_ptr<FileSink> file;
+    /// @brief Size of the current file, including what is still buffered
+    size_t fileSize = 0;
+    LogClock::time_point nextRotation;
+    unsigned long long rotationsCount = 0;
+
+    std::mutex archiveMutex;
+    std::condition_variable archiveCondition;
+    std::condition_variable archivedCondition;
+    /// @brief The closed files waiting to be archived, oldest first
+    std::deque<std::string> pendingFiles;
+    bool isArchiving = false;
+    bool isStopping = false;
+    std::thread archiveThread;
+};
+
+/**
+ * @brief The settings of a `RingFileSink`
+ */
+struct RingFileSinkOptions {
+    /// @brief Size, in bytes, of the logs kept by the ring
+    size_t capacity = TINYLOG_RING_FILE_DEFAULT_CAPACITY;
+    /// @brief When to ask the system to persist the ring to the disk ; the page cache already survives a crash of the
+    ///     program, only a crash of the system needs it
+    FileSyncPolicy syncPolicy = FileSyncPolicy::NEVER;
+    /// @brief Minimal time between two persists, with the `FileSyncPolicy::INTERVAL` policy
+    std::chrono::milliseconds syncInterval{1000};
+};
+
+/**
+ * @brief A sink writing into a memory-mapped file of fixed size, used as a ring buffer : logging is a copy into the
+ *      page cache, without any system call, and the last logs survive a crash of the program.
+ * @note Read it back with `RingFileReader` or the `tinylog_ring_dump` tool. An existing ring of the same capacity is
+ *      continued rather than cleared. As the oldest logs are overwritten, use it with string or `JsonFormat::NDJSON`
+ *      outputs, whose logs can be read on their own.
+ */
+class RingFileSink : public Sink {
+public:
+    /**
+     * @param path The path of the ring file. Created if it doesn't exist.
+     * @param options The settings of the sink.
+     * @note If the file can't be created or mapped, `isOpen()` returns false and every log is discarded.
+     */
+    explicit RingFileSink(const std::string& path, RingFileSinkOptions options = {}) : options(options) {
+        if (options.capacity <= sizeof(std::uint32_t))
+            return;
+        int fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fileDescriptor < 0)
+            return;
+        mappedSize = RingFileHeader::dataOffset + options.capacity;
+        struct stat fileStatus{};
+        bool isExisting = fstat(fileDescriptor, &fileStatus) == 0 && static_cast<size_t>(fileStatus.st_size) == mappedSize;
+        if (isExisting || ftruncate(fileDescriptor, static_cast<off_t>(mappedSize)) == 0) {
+            void* memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+            if (memory != MAP_FAILED)
+                mapping = static_cast<char*>(memory);
+        }
+        ::close(fileDescriptor);
+        if (mapping == nullptr)
+            return;
+
+        header = reinterpret_cast<RingFileHeader*>(mapping);
+        data = mapping + RingFileHeader::dataOffset;
+        bool isValid = isExisting && std::string_view(header->fileMagic, 8) == RingFileHeader::magic
+            && header->version == RingFileHeader::currentVersion && header->capacity == options.capacity
+            && header->oldestPosition <= header->writePosition && header->writePosition - header->oldestPosition <= options.capacity;
+        if (!isValid) {
+            std::memset(header, 0, sizeof(RingFileHeader));
+            std::memcpy(header->fileMagic, RingFileHeader::magic.data(), 8);
+            header->version = RingFileHeader::currentVersion;
+            header->capacity = options.capacity;
+        }
+        lastSync = LogClock::now();
+    }
+
+    ~RingFileSink() override {
+        if (mapping == nullptr)
+            return;
+        if (options.syncPolicy != FileSyncPolicy::NEVER)
+            sync();
+        munmap(mapping, mappedSize);
+    }
+
+    RingFileSink(const RingFileSink&) = delete;
+    RingFileSink& operator=(const RingFileSink&) = delete;
+
+    /// @brief Returns whether the ring file was successfully mapped
+    bool isOpen() const {
+        return mapping != nullptr;
+    }
+
+    void write(std::string_view entry, const LogRecord* record) override {
+        if (mapping == nullptr)
+            return;
+        const std::uint64_t capacity = header->capacity;
+        entry = entry.substr(0, capacity - sizeof(std::uint32_t));
+        std::uint32_t entrySize = static_cast<std::uint32_t>(entry.size());
+        std::uint64_t writePosition = header->writePosition;
+        std::uint64_t nextWritePosition = writePosition + sizeof(entrySize) + entrySize;
+
+        // Forgets the oldest entries first, so that a reader never starts on an overwritten one
+        std::uint64_t oldestPosition = header->oldestPosition;
+        while (nextWritePosition - oldestPosition > capacity) {
+            std::uint32_t oldestSize;
+            copyFromRing(&oldestSize, oldestPosition, sizeof(oldestSize));
+            oldestPosition += sizeof(oldestSize) + oldestSize;
+        }
+        header->oldestPosition = oldestPosition;
+        std::atomic_thread_fence(std::memory_order_release);
+
+        copyToRing(writePosition, &entrySize, sizeof(entrySize));
+        copyToRing(writePosition + sizeof(entrySize), entry.data(), entry.size());
+        // Publishes the entry only once it is whole
+        std::atomic_thread_fence(std::memory_order_release);
+        header->writePosition = nextWritePosition;
+
+        if (record == nullptr)
+            return;
+        if (options.syncPolicy == FileSyncPolicy::ON_ERROR && static_cast<char>(record->logLevel) >= static_cast<char>(ERROR))
+            sync();
+        else if (options.syncPolicy == FileSyncPolicy::INTERVAL && record->timestamp - lastSync >= options.syncInterval)
+            sync();
+    }
+
+    /**
+     * @brief Asks the system to persist the ring to the disk
+     */
+    void sync() {
+        if (mapping == nullptr)
+            return;
+        msync(mapping, mappedSize, MS_SYNC);
+        lastSync = LogClock::now();
+    }
+
+    /// @note The ring is already in the mapped file, which outlives the process : only the given text is written.
+    void emergencyWrite(std::string_view data) override {
+        if (!data.empty())
+            write(data, nullptr);
+    }
+
+private:
+    /// @brief Copies the given bytes into the ring, at the given position, wrapping around at the end of the data
+    void copyToRing(std::uint64_t position, const void* source, size_t size) {
+        size_t offset = static_cast<size_t>(position % header->capacity);
+        size_t firstPartSize = std::min(size, static_cast<size_t>(header->capacity) - offset);
+        std::memcpy(data + offset, source, firstPartSize);
+        std::memcpy(data, static_cast<const char*>(source) + firstPartSize, size - firstPartSize);
+    }
+
+    /// @brief Copies bytes out of the ring, from the given position, wrapping around at the end of the data
+    void copyFromRing(void* destination, std::uint64_t position, size_t size) const {
+        size_t offset = static_cast<size_t>(position % header->capacity);
+        size_t firstPartSize = std::min(size, static_cast<size_t>(header->capacity) - offset);
+        std::memcpy(destination, data + offset, firstPartSize);
+        std::memcpy(static_cast<char*>(destination) + firstPartSize, data, size - firstPartSize);
+    }
+
+    RingFileSinkOptions options;
+    char* mapping = nullptr;
+    size_t mappedSize = 0;
+    RingFileHeader* header = nullptr;
+    char* data = nullptr;
+    LogClock::time_point lastSync{};
+};
+#endif
+
+/**
+ * @brief Reads the entries of the file of a `RingFileSink` (see `RingFileHeader`), oldest first.
+ * @note Available on every platform, so that rings can be read anywhere, as long as the endianness is the same.
+ */
+class RingFileReader {
+public:
+    /**
+     * @param ringFile The content of a ring file. Must outlive the reader, and the entries it returns.
+     */
+    explicit RingFileReader(std::string_view ringFile) : file(ringFile) {
+        if (file.size() < RingFileHeader::dataOffset || file.substr(0, RingFileHeader::magic.size()) != RingFileHeader::magic)
+            return;
+        RingFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        capacity = header.capacity;
+        writePosition = header.writePosition;
+        position = header.oldestPosition;
+        isValid = header.version == RingFileHeader::currentVersion && capacity > 0 && file.size() - RingFileHeader::dataOffset >= capacity
+            && position <= writePosition && writePosition - position <= capacity;
+    }
+
+    /// @brief Returns whether the ring file is valid, and has been read without error so far
+    bool isGood() const {
+        return isValid;
+    }
+
+    /**
+     * @brief Reads the next entry
+     * @param entry Where to store the entry. Stays valid until the next call.
+     * @returns Whether an entry was read ; false once every entry has been read, or if the ring is corrupted.
+     */
+    bool next(std::string_view& entry) {
+        if (!isValid || position >= writePosition)
+            return false;
+        std::uint32_t entrySize;
+        copy(&entrySize, position, sizeof(entrySize));
+        if (writePosition - position - sizeof(entrySize) < entrySize) {
+            isValid = false;
+            return false;
+        }
+        size_t offset = static_cast<size_t>((position + sizeof(entrySize)) % capacity);
+        if (offset + entrySize <= capacity) {
+            entry = file.substr(RingFileHeader::dataOffset + offset, entrySize);
+        } else {
+            wrappedEntry.resize(entrySize);
+            copy(&wrappedEntry[0], position + sizeof(entrySize), entrySize);
+            entry = wrappedEntry;
+        }
+        position += sizeof(entrySize) + entrySize;
+        return true;
+    }
+
+private:
+    void copy(void* destination, std::uint64_t from, size_t size) const {
+        const char* ringData = file.data() + RingFileHeader::dataOffset;
+        size_t offset = static_cast<size_t>(from % capacity);
+        size_t firstPartSize = std::min(size, static_cast<size_t>(capacity) - offset);
+        std::memcpy(destination, ringData + offset, firstPartSize);
+        std::memcpy(static_cast<char*>(destination) + firstPartSize, ringData, size - firstPartSize);
+    }
+
+    std::string_view file;
+    bool isValid = false;
+    std::uint64_t capacity = 0;
+    std::uint64_t writePosition = 0;
+    std::uint64_t position = 0;
+    /// @brief Storage for the current entry, as it may wrap around the end of the ring
+    std::string wrappedEntry;
+};
+
+#if TINYLOG_HAS_POSIX == 1
+/**
+ * @brief The geometry of the shared memory segment of the `SharedMemorySink`s and the `SharedMemoryCollector` of a
+ *      host ; must be the same in every process using the segment.
+ */
+struct SharedMemoryOptions {
+    /// @brief How many processes can write into the segment at the same time
+    size_t slotsCount = 16;
+    /// @brief Size, in bytes, of the ring of each process
+    size_t ringCapacity = TINYLOG_SHARED_MEMORY_DEFAULT_RING_CAPACITY;
+};
+
+/**
+ * @brief A POSIX shared memory segment holding one ring per writing process, mapped by each `SharedMemorySink` and by
+ *      the `SharedMemoryCollector`.
+ * @note The segment is a `Header`, followed by `slotsCount` slots : a `Slot`, then its ring. A ring has a single
+ *      producer, the process owning the slot, and a single consumer, the collector ; they only share two positions,
+ *      each on its own cache line. Each entry is an `EntryHeader`, followed by the formatted log, wrapping around at
+ *      the end of the ring.
+ * @note The first process to open the segment creates and initializes it. It stays until `remove()` is called, even
+ *      once every process has unmapped it, so that a restarted collector finds the logs it hasn't collected yet.
+ */
+class SharedMemorySegment {
+public:
+    static constexpr std::uint32_t currentVersion = 1;
+
+    /// @brief Whose turn it is to use a slot
+    enum SlotState: std::uint32_t {
+        /// @brief No process writes into the ring, which is empty
+        FREE = 0,
+        /// @brief A process writes into the ring
+        OWNED,
+        /// @brief The process released the ring, whose last logs are yet to be collected
+        RELEASED
+    };
+
+    struct Header {
+        /// @brief 0 until a process starts initializing the segment, 1 while it does, 2 once it is initialized
+        std::atomic<std::uint32_t> initializationState;
+        std::uint32_t version;
+        std::uint64_t slotsCount;
+        std::uint64_t ringCapacity;
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint32_t> state;
+        /// @brief The process owning the slot, to free it if it died without releasing it
+        std::atomic<std::int32_t> ownerPid;
+        /// @brief How many logs the owners of the slot dropped, as the ring was full
+        std::atomic<std::uint64_t> droppedCount;
+        /// @brief How many bytes were written into the ring, only written by its owner
+        alignas(64) std::atomic<std::uint64_t> writePosition;
+        /// @brief How many bytes were read from the ring, only written by the collector
+        alignas(64) std::atomic<std::uint64_t> readPosition;
+    };
+
+    struct EntryHeader {
+        /// @brief Size of the formatted log following the header
+        std::uint32_t size;
+        std::int8_t logLevel;
+        std::uint8_t reserved[3];
+        /// @brief Microseconds since the epoch
+        std::int64_t timestamp;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Atomics shared between processes must be lock-free");
+
+    /**
+     * @brief Opens the given segment, creating it if it doesn't exist
+     * @param name The name of the segment, e.g. `/tinylog` ; a `/` is prepended if missing.
+     * @param options The geometry of the segment. If the segment exists with another geometry, `isOpen()` returns false.
+     */
+    SharedMemorySegment(const std::string& name, const SharedMemoryOptions& options) {
+        if (options.slotsCount == 0 || options.ringCapacity <= sizeof(EntryHeader))
+            return;
+        slotSize = (sizeof(Slot) + options.ringCapacity + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        mappedSize = slotsOffset + options.slotsCount * slotSize;
+        int fileDescriptor = ::shm_open(getPosixName(name).c_str(), O_RDWR | O_CREAT, 0600);
+        if (fileDescriptor < 0)
+            return;
+        struct stat fileStatus{};
+        bool isSized = fstat(fileDescriptor, &fileStatus) == 0
+            && (static_cast<size_t>(fileStatus.st_size) == mappedSize || (fileStatus.st_size == 0 && ftruncate(fileDescriptor, static_cast<off_t>(mappedSize)) == 0));
+        if (isSized) {
+            void* memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+            if (memory != MAP_FAILED)
+                mapping = static_cast<char*>(memory);
+        }
+        ::close(fileDescriptor);
+        if (mapping == nullptr)
+            return;
+
+        // A new segment is filled with zeros : positions, counters and states start at 0
+        Header* header = reinterpret_cast<Header*>(mapping);
+        std::uint32_t expectedState = 0;
+        if (header->initializationState.compare_exchange_strong(expectedState, 1, std::memory_order_acq_rel)) {
+            header->version = currentVersion;
+            header->slotsCount = options.slotsCount;
+            header->ringCapacity = options.ringCapacity;
+            header->initializationState.store(2, std::memory_order_release);
+        } else {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (header->initializationState.load(std::memory_order_acquire) != 2 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        isValid = header->initializationState.load(std::memory_order_acquire) == 2 && header->version == currentVersion
+            && header->slotsCount == options.slotsCount && header->ringCapacity == options.ringCapacity;
+        slotsCount = options.slotsCount;
+        ringCapacity = options.ringCapacity;
+    }
+
+    ~SharedMemorySegment() {
+        if (mapping != nullptr)
+            munmap(mapping, mappedSize);
+    }
+
+    SharedMemorySegment(const SharedMemorySegment&) = delete;
+    SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+    /**
+     * @brief Removes the given segment ; the processes that mapped it keep using it until they unmap it
+     * @returns Whether the segment existed and was removed.
+     */
+    static bool remove(const std::string& name) {
+        return ::shm_unlink(getPosixName(name).c_str()) == 0;
+    }
+
+    /// @brief Returns whether the segment is mapped, with the expected geometry
+    bool isOpen() const {
+        return isValid;
+    }
+
+    size_t getSlotsCount() const {
+        return slotsCount;
+    }
+
+    size_t getRingCapacity() const {
+        return ringCapacity;
+    }
+
+    Slot& getSlot(size_t index) {
+        return *reinterpret_cast<Slot*>(mapping + slotsOffset + index * slotSize);
+    }
+
+    /// @brief Copies the given bytes into the ring of the given slot, at the given position, wrapping around at its end
+    void copyToRing(size_t index, std::uint64_t position, const void* source, size_t size) {
+        char* ring = mapping + slotsOffset + index * slotSize + sizeof(Slot);
+        size_t offset = static_cast<size_t>(position % ringCapacity);
+        size_t firstPartSize = std::min(size, ringCapacity - offset);
+        std::memcpy(ring + offset, source, firstPartSize);
+        std::memcpy(ring, static_cast<const char*>(source) + firstPartSize, size - firstPartSize);
+    }
+
+    /// @brief Copies bytes out of the ring of the given slot, from the given position, wrapping around at its end
+    void copyFromRing(size_t index, void* destination, std::uint64_t position, size_t size) const {
+        const char* ring = mapping + slotsOffset + index * slotSize + sizeof(Slot);
+        size_t offset = static_cast<size_t>(position % ringCapacity);
+        size_t firstPartSize = std::min(size, ringCapacity - offset);
+        std::memcpy(destination, ring + offset, firstPartSize);
+        std::memcpy(static_cast<char*>(destination) + firstPartSize, ring, size - firstPartSize);
+    }
+
+private:
+    /// @brief Offset of the first slot, leaving the header alone on its cache line
+    static constexpr size_t slotsOffset = alignof(Slot);
+
+    static std::string getPosixName(const std::string& name) {
+        return (!name.empty() && name[0] == '/') ? name : "/" + name;
+    }
+
+    char* mapping = nullptr;
+    size_t mappedSize = 0;
+    size_t slotSize = 0;
+    size_t slotsCount = 0;
+    size_t ringCapacity = 0;
+    bool isValid = false;
+};
+
+/**
+ * @brief A sink writing into a ring of a shared memory segment, drained by a `SharedMemoryCollector` in another
+ *      process : the worker processes of a host log through a single writer, rather than each appending to its files.
+ * @note Writing a log is a copy into the ring, without any lock or system call. When the ring is full, as the
+ *      collector lags behind, the log is dropped : a worker never waits for the collector.
+ * @note Framing text is ignored, as the logs of the processes are interleaved : use it with string or
+ *      `JsonFormat::NDJSON` outputs. The ring is released when the sink is destroyed ; don't use it from forked children.
+ */
+class SharedMemorySink : public Sink {
+public:
+    /**
+     * @param name The name of the segment, shared with the collector
+     * @param options The geometry of the segment, shared with the collector
+     * @note If the segment can't be opened, or all of its rings are owned, `isOpen()` returns false and every log is
+     *      discarded.
+     */
+    explicit SharedMemorySink(const std::string& name, const SharedMemoryOptions& options = {}) : segment(name, options) {
+        if (!segment.isOpen())
+            return;
+        for (size_t i = 0; i < segment.getSlotsCount(); i++) {
+            SharedMemorySegment::Slot& candidate = segment.getSlot(i);
+            std::uint32_t state = SharedMemorySegment::FREE;
+            bool isClaimed = candidate.state.compare_exchange_strong(state, SharedMemorySegment::OWNED, std::memory_order_acq_rel);
+            // A released ring can be reused once the collector has emptied it
+            if (!isClaimed && state == SharedMemorySegment::RELEASED
+                && candidate.readPosition.load(std::memory_order_acquire) == candidate.writePosition.load(std::memory_order_relaxed))
+                isClaimed = candidate.state.compare_exchange_strong(state, SharedMemorySegment::OWNED, std::memory_order_acq_rel);
+            if (isClaimed) {
+                candidate.ownerPid.store(static_cast<std::int32_t>(::getpid()), std::memory_order_relaxed);
+                slot = &candidate;
+                slotIndex = i;
+                writePosition = candidate.writePosition.load(std::memory_order_relaxed);
+                cachedReadPosition = candidate.readPosition.load(std::memory_order_acquire);
+                return;
+            }
+        }
+    }
+
+    /// @brief Releases the ring ; the collector still collects its last logs
+    ~SharedMemorySink() override {
+        if (slot != nullptr)
+            slot->state.store(SharedMemorySegment::RELEASED, std::memory_order_release);
+    }
+
+    SharedMemorySink(const SharedMemorySink&) = delete;
+    SharedMemorySink& operator=(const SharedMemorySink&) = delete;
+
+    /// @brief Returns whether the sink owns a ring of the segment
+    bool isOpen() const {
+        return slot != nullptr;
+    }
+
+    void write(std::string_view data, const LogRecord* record) override {
+        if (slot == nullptr || record == nullptr)
+            return;
+        push(data, record->logLevel, record->timestamp);
+    }
+
+    /// @note The shared memory outlives the process : the text is written as a `FATAL` log, for the collector to find.
+    void emergencyWrite(std::string_view data) override {
+        if (slot != nullptr && !data.empty())
+            push(data, FATAL, LogClock::now());
+    }
+
+    /// @brief Returns how many logs were dropped since the segment was created, by any owner of the ring, as it was full
+    unsigned long long getDroppedCount() const {
+        return slot != nullptr ? slot->droppedCount.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    /// @brief Copies the given log into the ring, then publishes it
+    void push(std::string_view data, LogLevel logLevel, LogClock::time_point timestamp) {
+        size_t entrySize = sizeof(SharedMemorySegment::EntryHeader) + data.size();
+        if (writePosition + entrySize - cachedReadPosition > segment.getRingCapacity()) {
+            cachedReadPosition = slot->readPosition.load(std::memory_order_acquire);
+            if (writePosition + entrySize - cachedReadPosition > segment.getRingCapacity()) {
+                slot->droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        SharedMemorySegment::EntryHeader header{};
+        header.size = static_cast<std::uint32_t>(data.size());
+        header.logLevel = static_cast<std::int8_t>(logLevel);
+        header.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(timestamp.time_since_epoch()).count();
+        segment.copyToRing(slotIndex, writePosition, &header, sizeof(header));
+        segment.copyToRing(slotIndex, writePosition + sizeof(header), data.data(), data.size());
+        writePosition += entrySize;
+        slot->writePosition.store(writePosition, std::memory_order_release);
+    }
+
+    SharedMemorySegment segment;
+    SharedMemorySegment::Slot* slot = nullptr;
+    size_t slotIndex = 0;
+    std::uint64_t writePosition = 0;
+    /// @brief The last read position of the collector seen, only read again when the ring looks full
+    std::uint64_t cachedReadPosition = 0;
+};
+
+/**
+ * @brief The settings of a `SharedMemoryCollector`
+ */
+struct SharedMemoryCollectorOptions {
+    /// @brief Time the collector thread waits when every ring is empty. 0 disables the thread : call `collect()` instead.
+    std::chrono::milliseconds pollInterval{10};
+};
+
+/**
+ * @brief Drains the rings of the `SharedMemorySink`s of a shared memory segment into a single sink, e.g. a
+ *      `RollingFileSink` or a `NetworkSink`, from a dedicated thread.
+ * @note The logs waiting in the rings are merged by timestamp on each pass, each ring being in order. The destination is given the
+ *      formatted logs, with a `LogRecord` only holding their level and timestamp, with the formatted log as message.
+ * @note Frees the rings released by their process, or whose process died, once it has emptied them.
+ * @note The `tinylog_collect` tool runs a collector writing to a rolling file.
+ */
+class SharedMemoryCollector {
+public:
+    /**
+     * @param name The name of the segment, shared with the sinks
+     * @param destinationSink The sink the logs are written to. Must outlive the collector.
+     * @param options The geometry of the segment, shared with the sinks
+     * @param collectorOptions The settings of the collector
+     */
+    SharedMemoryCollector(const std::string& name, Sink& destinationSink, const SharedMemoryOptions& options = {},
+                          SharedMemoryCollectorOptions collectorOptions = {}) :
+        segment(name, options), destination(&destinationSink), collectorOptions(collectorOptions) {
+        if (segment.isOpen() && collectorOptions.pollInterval.count() > 0)
+            collectorThread = std::thread([this]() { run(); });
+    }
+
+    /// @brief Stops the collector thread, then collects the last logs
+    ~SharedMemoryCollector() {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            isStopping = true;
+        }
+        stopCondition.notify_one();
+        if (collectorThread.joinable())
+            collectorThread.join();
+        collect();
+    }
+
+    SharedMemoryCollector(const SharedMemoryCollector&) = delete;
+    SharedMemoryCollector& operator=(const SharedMemoryCollector&) = delete;
+
+    /// @brief Returns whether the segment is mapped, with the expected geometry
+    bool isOpen() const {
+        return segment.isOpen();
+    }
+
+    /**
+     * @brief Writes every log waiting in the rings to the destination, oldest first, then flushes it
+     * @returns How many logs were written.
+     */
+    size_t collect() {
+        std::lock_guard<std::mutex> lock(collectMutex);
+        if (!segment.isOpen())
+            return 0;
+
+        // The rings to drain, with the end of their logs as of now
+        pendingRings.clear();
+        for (size_t i = 0; i < segment.getSlotsCount(); i++) {
+            SharedMemorySegment::Slot& slot = segment.getSlot(i);
+            if (slot.state.load(std::memory_order_acquire) == SharedMemorySegment::FREE)
+                continue;
+            std::uint64_t writePosition = slot.writePosition.load(std::memory_order_acquire);
+            std::uint64_t readPosition = slot.readPosition.load(std::memory_order_relaxed);
+            if (readPosition != writePosition)
+                pendingRings.push_back({i, readPosition, writePosition, {}});
+            else
+                freeIfAbandoned(slot);
+        }
+        for (PendingRing& ring : pendingRings) {
+            segment.copyFromRing(ring.index, &ring.nextEntry, ring.readPosition, sizeof(ring.nextEntry));
+        }
+
+        size_t collectedCount = 0;
+        while (true) {
+            PendingRing* oldestRing = nullptr;
+            for (PendingRing& ring : pendingRings) {
+                if (ring.readPosition < ring.writePosition && (oldestRing == nullptr || ring.nextEntry.timestamp < oldestRing->nextEntry.timestamp))
+                    oldestRing = &ring;
+            }
+            if (oldestRing == nullptr)
+                break;
+            writeEntry(*oldestRing);
+            collectedCount++;
+        }
+        for (const PendingRing& ring : pendingRings) {
+            segment.getSlot(ring.index).readPosition.store(ring.readPosition, std::memory_order_release);
+        }
+
+        if (collectedCount > 0) {
+            destination->flush();
+            collectedLogsCount.fetch_add(static_cast<long long>(collectedCount), std::memory_order_relaxed);
+        }
+        return collectedCount;
+    }
+
+    /// @brief Returns how many logs were written to the destination
+    long long getCollectedCount() const {
+        return collectedLogsCount.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns how many logs the sinks dropped since the segment was created, as their ring was full
+    unsigned long long getDroppedCount() {
+        unsigned long long droppedCount = 0;
+        for (size_t i = 0; segment.isOpen() && i < segment.getSlotsCount(); i++) {
+            droppedCount += segment.getSlot(i).droppedCount.load(std::memory_order_relaxed);
+        }
+        return droppedCount;
+    }
+
+private:
+    /// @brief A ring being drained by `collect()`
+    struct PendingRing {
+        size_t index;
+        std::uint64_t readPosition;
+        std::uint64_t writePosition;
+        /// @brief The header of the entry at `readPosition`
+        SharedMemorySegment::EntryHeader nextEntry;
+    };
+
+    /// @brief Writes the next entry of the given ring to the destination, and reads the header of the one after it
+    void writeEntry(PendingRing& ring) {
+        const SharedMemorySegment::EntryHeader& header = ring.nextEntry;
+        std::uint64_t dataPosition = ring.readPosition + sizeof(header);
+        // A corrupted header, e.g. written by a process that died mid-write, skips the rest of the ring
+        if (header.size > ring.writePosition - dataPosition) {
+            ring.readPosition = ring.writePosition;
+            return;
+        }
+        entry.resize(header.size);
+        segment.copyFromRing(ring.index, &entry[0], dataPosition, header.size);
+        ring.readPosition = dataPosition + header.size;
+        if (ring.readPosition < ring.writePosition)
+            segment.copyFromRing(ring.index, &ring.nextEntry, ring.readPosition, sizeof(ring.nextEntry));
+
+        LogLevel logLevel = (header.logLevel >= DEBUG && header.logLevel <= FATAL) ? static_cast<LogLevel>(header.logLevel) : INFO;
+        LogClock::time_point timestamp{std::chrono::duration_cast<LogClock::duration>(std::chrono::microseconds(header.timestamp))};
+        LogRecord record{logLevel, timestamp, true, "", -1, entry, nullptr, 0};
+        destination->write(entry, &record);
+    }
+
+    /// @brief Frees the given empty slot, if its process released it or died
+    void freeIfAbandoned(SharedMemorySegment::Slot& slot) {
+        std::uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == SharedMemorySegment::OWNED) {
+            pid_t ownerPid = static_cast<pid_t>(slot.ownerPid.load(std::memory_order_relaxed));
+            if (ownerPid <= 0 || ::kill(ownerPid, 0) == 0 || errno != ESRCH)
+                return;
+        }
+        slot.state.compare_exchange_strong(state, SharedMemorySegment::FREE, std::memory_order_acq_rel);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!isStopping) {
+            lock.unlock();
+            size_t collectedCount = collect();
+            lock.lock();
+            if (collectedCount == 0)
+                stopCondition.wait_for(lock, collectorOptions.pollInterval);
+        }
+    }
+
+    SharedMemorySegment segment;
+    Sink* destination;
+    SharedMemoryCollectorOptions collectorOptions;
+    std::mutex collectMutex;
+    std::vector<PendingRing> pendingRings;
+    /// @brief Storage for the current entry, as it may wrap around the end of its ring
+    std::string entry;
+    std::atomic<long long> collectedLogsCount{0};
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool isStopping = false;
+    std::thread collectorThread;
+};
+#endif
+
+/**
+ * @brief The compact binary log format, written by `BinarySink` and read by `BinaryLogReader`.
+ *
+ * A binary log starts with the 8 bytes of `magic`, followed by entries starting with a tag byte :
+ * - `CALL_SITE` : a varint call-site ID (1, 2, ...), a length-prefixed file path, a varint line number + 1 and the
+ *      length-prefixed message of the first log of this call site.
+ * - `LOG` : a level byte, a flags byte, the zigzag varint delta in microseconds from the timestamp of the previous log,
+ *      the varint call-site ID, the length-prefixed message if the `MESSAGE_INLINE` flag is set (otherwise the message
+ *      is the one of the call site), a varint extras count and the length-prefixed extras. If the `HAS_FIELDS` flag is
+ *      set, they are followed by a varint fields count and the fields : the length-prefixed key, a `FieldType` byte, then
+ *      a zigzag varint (`INTEGER`, `DURATION`), a varint (`UNSIGNED_INTEGER`), 8 little-endian bytes (`FLOATING_POINT`),
+ *      a byte (`BOOLEAN`) or a length-prefixed string (`STRING`).
+ * Lengths are varints too.
+ */
+namespace BinaryFormat {
+    constexpr std::string_view magic = std::string_view("TLOGBIN1", 8);
+
+    enum Tag: unsigned char {
+        CALL_SITE = 1,
+        LOG = 2
+    };
+
+    enum Flags: unsigned char {
+        SHOW_TIMESTAMP = 1,
+        MESSAGE_INLINE = 2,
+        HAS_FIELDS = 4
+    };
+
+    /// @brief Maps signed integers to unsigned ones, small in absolute value ones staying small
+    inline std::uint64_t toZigzag(long long value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    /// @brief Reverts `toZigzag()`
+    inline long long fromZigzag(std::uint64_t value) {
+        return static_cast<long long>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    /// @brief Returns the microseconds since the epoch of the given time
+    inline long long toMicroseconds(LogClock::time_point timestamp) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(timestamp.time_since_epoch()).count();
+    }
+}
+
+/**
+ * @brief A sink encoding logs in the compact binary format (see `BinaryFormat`), and writing them to another sink.
+ * @note Each file path and line number is interned as a call site the first time it is logged, so the following logs
+ *      only carry its ID. Use it with `Logger::enableBinaryOutput()`, and read it back with `BinaryLogReader` or the
+ *      `tinylog_decode` tool.
+ */
+class BinarySink : public Sink {
+public:
+    /**
+     * @param destinationSink The sink the encoded logs are written to, e.g. a `FileSink`. Must outlive this sink.
+     */
+    explicit BinarySink(Sink& destinationSink) : destination(&destinationSink) {}
+
+    /**
+     * @param outputStream The stream the encoded logs are written to. Should be opened in binary mode.
+     */
+    explicit BinarySink(std::ostream& outputStream) :
+        destination(nullptr), ownedDestination(std::make_unique<OstreamSink>(outputStream)) {
+        destination = ownedDestination.get();
+    }
+
+    /// @brief Encodes the given log and writes it to the destination ; framing text is ignored
+    void write(std::string_view, const LogRecord* record) override {
+        if (record == nullptr)
+            return;
+        buffer.clear();
+        if (!isHeaderWritten) {
+            buffer.append(BinaryFormat::magic);
+            isHeaderWritten = true;
+        }
+
+        InternedCallSite& callSite = internCallSite(*record);
+        bool isMessageInline = record->message != callSite.message;
+
+        long long timestamp = BinaryFormat::toMicroseconds(record->timestamp);
+        long long timestampDelta = timestamp - previousTimestamp;
+        previousTimestamp = timestamp;
+
+        buffer.append(static_cast<char>(BinaryFormat::LOG));
+        buffer.append(static_cast<char>(record->logLevel));
+        buffer.append(static_cast<char>((record->showTimestamp ? BinaryFormat::SHOW_TIMESTAMP : 0) | (isMessageInline ? BinaryFormat::MESSAGE_INLINE : 0)
+                                        | (record->fieldsCount + record->contextFieldsCount > 0 ? BinaryFormat::HAS_FIELDS : 0)));
+        buffer.appendVarint(BinaryFormat::toZigzag(timestampDelta));
+        buffer.appendVarint(callSite.id);
+        if (isMessageInline)
+            appendString(record->message);
+        buffer.appendVarint(record->extrasCount);
+        for (size_t i = 0; i < record->extrasCount; i++) {
+            appendString(record->extras[i]);
+        }
+        // The fields of the context are encoded as fields
+        if (record->fieldsCount + record->contextFieldsCount > 0) {
+            buffer.appendVarint(record->fieldsCount + record->contextFieldsCount);
+            for (size_t i = 0; i < record->fieldsCount; i++) {
+                appendField(record->fields[i]);
+            }
+            for (size_t i = 0; i < record->contextFieldsCount; i++) {
+                appendField(record->contextFields[i]);
+            }
+        }
+        destination->write(buffer.view(), record);
+    }
+
+    void flush() override {
+        destination->flush();
+    }
+
+    void emergencyWrite(std::string_view data) override {
+        destination->emergencyWrite(data);
+    }
+
+private:
+    struct InternedCallSite {
+        std::uint64_t id;
+        std::string filePath;
+        int lineNumber;
+        std::string message;
+    };
+
+    void appendString(std::string_view text) {
+        buffer.appendVarint(text.size());
+        buffer.append(text);
+    }
+
+    void appendField(const Field& field) {
+        appendString(field.key);
+        buffer.append(static_cast<char>(field.type));
+        switch (field.type) {
+            case FieldType::INTEGER:          buffer.appendVarint(BinaryFormat::toZigzag(field.integer)); break;
+            case FieldType::DURATION:         buffer.appendVarint(BinaryFormat::toZigzag(field.nanoseconds)); break;
+            case FieldType::UNSIGNED_INTEGER: buffer.appendVarint(field.unsignedInteger); break;
+            case FieldType::BOOLEAN:          buffer.append(static_cast<char>(field.boolean)); break;
+            case FieldType::STRING:           appendString(field.string); break;
+            case FieldType::FLOATING_POINT: {
+                std::uint64_t bits;
+                std::memcpy(&bits, &field.floatingPoint, sizeof(bits));
+                for (int i = 0; i < 8; i++) {
+                    buffer.append(static_cast<char>(bits >> (8 * i)));
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the call site of the given log, defining it in the buffer if it is new
+     */
+    InternedCallSite& internCallSite(const LogRecord& record) {
+        // Logs from the logging macros are identified by their static call site, without hashing the file path
+        if (record.callSite != nullptr) {
+            auto position = callSitesByPointer.find(record.callSite);
+            if (position != callSitesByPointer.end())
+                return callSites[position->second];
+            callSitesByPointer.emplace(record.callSite, callSites.size());
+            return defineCallSite(record);
+        }
+
+        std::uint64_t hash = std::hash<std::string_view>()(record.filePath) * 31 + static_cast<std::uint64_t>(record.lineNumber);
+        auto [first, last] = callSitesByHash.equal_range(hash);
+        for (auto position = first; position != last; ++position) {
+            InternedCallSite& callSite = callSites[position->second];
+            if (callSite.lineNumber == record.lineNumber && callSite.filePath == record.filePath)
+                return callSite;
+        }
+
+        callSitesByHash.emplace(hash, callSites.size());
+        return defineCallSite(record);
+    }
+
+    /// @brief Interns the call site of the given log, and defines it in the buffer
+    InternedCallSite& defineCallSite(const LogRecord& record) {
+        callSites.push_back(InternedCallSite{callSites.size() + 1, std::string(record.filePath), record.lineNumber, std::string(record.message)});
+        InternedCallSite& callSite = callSites.back();
+        buffer.append(static_cast<char>(BinaryFormat::CALL_SITE));
+        buffer.appendVarint(callSite.id);
+        appendString(callSite.filePath);
+        buffer.appendVarint(static_cast<std::uint64_t>(callSite.lineNumber + 1));
+        appendString(callSite.message);
+        return callSite;
+    }
+
+    Sink* destination;
+    std::unique_ptr<Sink> ownedDestination;
+    FormatBuffer buffer;
+    bool isHeaderWritten = false;
+    long long previousTimestamp = 0;
+    std::vector<InternedCallSite> callSites;
+    std::unordered_multimap<std::uint64_t, size_t> callSitesByHash;
+    std::unordered_map<const CallSite*, size_t> callSitesByPointer;
+};
+
+/**
+ * @brief Reads logs written in the compact binary format (see `BinaryFormat`).
+ */
+class BinaryLogReader {
+public:
+    /**
+     * @param binaryLog The content of a binary log. Must outlive the reader, and the records it returns.
+     */
+    explicit BinaryLogReader(std::string_view binaryLog) : data(binaryLog) {
+        isValid = data.substr(0, BinaryFormat::magic.size()) == BinaryFormat::magic;
+        position = isValid ? BinaryFormat::magic.size() : data.size();
+    }
+
+    /// @brief Returns whether the binary log starts with the right header, and has been read without error so far
+    bool isGood() const {
+        return isValid;
+    }
+
+    /**
+     * @brief Reads the next log
+     * @param record Where to store the log, reset first : the members the binary format doesn't hold are left empty. Its
+     *      views stay valid until the next call.
+     * @returns Whether a log was read ; false at the end of the binary log, or if it is truncated or corrupted.
+     */
+    bool next(LogRecord& record) {
+        record = LogRecord{};
+        while (isValid && position < data.size()) {
+            unsigned char tag = static_cast<unsigned char>(data[position++]);
+            if (tag == BinaryFormat::CALL_SITE) {
+                InternedCallSite callSite;
+                std::uint64_t id, lineNumber;
+                if (!readVarint(id) || !readString(callSite.filePath) || !readVarint(lineNumber) || !readString(callSite.message) || id != callSites.size() + 1)
+                    return fail();
+                callSite.lineNumber = static_cast<int>(lineNumber) - 1;
+                callSites.push_back(callSite);
+            } else if (tag == BinaryFormat::LOG) {
+                if (position + 2 > data.size())
+                    return fail();
+                // Checked here, as an invalid log level would terminate the program once named
+                char logLevel = data[position++];
+                if (logLevel < DEBUG || logLevel > FATAL)
+                    return fail();
+                record.logLevel = static_cast<LogLevel>(logLevel);
+                unsigned char flags = static_cast<unsigned char>(data[position++]);
+                std::uint64_t zigzagDelta, callSiteId, extrasCount;
+                if (!readVarint(zigzagDelta) || !readVarint(callSiteId) || callSiteId == 0 || callSiteId > callSites.size())
+                    return fail();
+                const InternedCallSite& callSite = callSites[callSiteId - 1];
+                record.message = callSite.message;
+                if ((flags & BinaryFormat::MESSAGE_INLINE) && !readString(record.message))
+                    return fail();
+                if (!readVarint(extrasCount) || extrasCount > data.size())
+                    return fail();
+                extras.resize(extrasCount);
+                for (std::string_view& extra : extras) {
+                    if (!readString(extra))
+                        return fail();
+                }
+                fields.clear();
+                if (flags & BinaryFormat::HAS_FIELDS) {
+                    std::uint64_t fieldsCount;
+                    if (!readVarint(fieldsCount) || fieldsCount > data.size())
+                        return fail();
+                    fields.resize(fieldsCount);
+                    for (Field& field : fields) {
+                        if (!readField(field))
+                            return fail();
+                    }
+                }
+                timestamp += BinaryFormat::fromZigzag(zigzagDelta);
+                record.timestamp = LogClock::time_point(std::chrono::duration_cast<LogClock::duration>(std::chrono::microseconds(timestamp)));
+                record.showTimestamp = (flags & BinaryFormat::SHOW_TIMESTAMP) != 0;
+                record.filePath = callSite.filePath;
+                record.lineNumber = callSite.lineNumber;
+                record.extras = extras.data();
+                record.extrasCount = extras.size();
+                record.fields = fields.data();
+                record.fieldsCount = fields.size();
+                return true;
+            } else {
+                return fail();
+            }
+        }
+        return false;
+    }
+
+private:
+    struct InternedCallSite {
+        std::string_view filePath;
+        int lineNumber = -1;
+        std::string_view message;
+    };
+
+    bool fail() {
+        isValid = false;
+        return false;
+    }
+
+    bool readVarint(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(data[position++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool readString(std::string_view& text) {
+        std::uint64_t size;
+        if (!readVarint(size) || size > data.size() - position)
+            return false;
+        text = data.substr(position, size);
+        position += size;
+        return true;
+    }
+
+    bool readField(Field& field) {
+        if (!readString(field.key) || position >= data.size())
+            return false;
+        field.type = static_cast<FieldType>(data[position++]);
+        std::uint64_t value;
+        switch (field.type) {
+            case FieldType::INTEGER:
+            case FieldType::DURATION:
+                if (!readVarint(value))
+                    return false;
+                field.integer = BinaryFormat::fromZigzag(value);
+                return true;
+            case FieldType::UNSIGNED_INTEGER:
+                if (!readVarint(value))
+                    return false;
+                field.unsignedInteger = value;
+                return true;
+            case FieldType::BOOLEAN:
+                if (position >= data.size())
+                    return false;
+                field.boolean = data[position++] != 0;
+                return true;
+            case FieldType::STRING:
+                return readString(field.string);
+            case FieldType::FLOATING_POINT:
+                if (data.size() - position < 8)
+                    return false;
+                value = 0;
+                for (int i = 0; i < 8; i++) {
+                    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[position++])) << (8 * i);
+                }
+                std::memcpy(&field.floatingPoint, &value, sizeof(value));
+                return true;
+        }
+        return false;
+    }
+
+    std::string_view data;
+    size_t position = 0;
+    bool isValid = false;
+    long long timestamp = 0;
+    std::vector<InternedCallSite> callSites;
+    std::vector<std::string_view> extras;
+    std::vector<Field> fields;
+};
+
+class NamedLogger;
+class ScopedLogLevel;
+
+class Logger  {
+    friend class NamedLogger;
+    friend class ScopedLogLevel;
+
+private:
+    /**
+     * @brief A sink, along with the lock making each log written to it atomic.
+     */
+    struct Output {
+        explicit Output(Sink& outputSink) : sink(&outputSink) {}
+        explicit Output(std::unique_ptr<Sink> outputSink) : sink(outputSink.get()), ownedSink(std::move(outputSink)) {}
+
+        /**
+         * @brief Writes the given formatted log to the sink, unless the output is closed
+         * @param data The formatted log
+         * @param record The log `data` was formatted from
+         * @param firstLogOffset How many characters to skip at the start of `data` if this is the first log of the output
+         */
+        void write(std::string_view data, const LogRecord& record, size_t firstLogOffset = 0) {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            if (isClosed || !startWriting())
+                return;
+            long long count = writtenCount.load(std::memory_order_relaxed);
+            if (count == 0)
+                data.remove_prefix(firstLogOffset);
+            sink->write(data, &record);
+            // Only written under the lock ; atomic so that `getMetrics()` can read them without it
+            writtenCount.store(count + 1, std::memory_order_relaxed);
+            writtenBytesCount.store(writtenBytesCount.load(std::memory_order_relaxed) + static_cast<long long>(data.size()), std::memory_order_relaxed);
+            stopWriting();
+        }
+
+        /**
+         * @brief Marks the sink as being written to, once `writeMutex` is held
+         * @returns False if the crash handler took the output over, in which case the sink must be left alone.
+         */
+        bool startWriting() {
+            return !isWriting.exchange(true, std::memory_order_acquire);
+        }
+
+        void stopWriting() {
+            isWriting.store(false, std::memory_order_release);
+        }
+
+        Sink* sink;
+        /// @brief The sink, if it was created by TinyLog (e.g. to wrap an `std::ostream`)
+        std::unique_ptr<Sink> ownedSink;
+        /// @brief Held while writing a whole log, so that logs from different threads don't interleave
+        std::mutex writeMutex;
+        /// @brief Set once the output is disabled, so that loggers still holding an older output list skip it
+        bool isClosed = false;
+        /**
+         * @brief Set while the sink is written to, so that the crash handler skips a sink it may have interrupted
+         *      mid-write, rather than waiting for a lock. Left set by the crash handler once it took the output over.
+         */
+        std::atomic<bool> isWriting{false};
+        /// @brief How many logs have been written to this output
+        std::atomic<long long> writtenCount{0};
+        /// @brief How many bytes of formatted logs have been written to this output
+        std::atomic<long long> writtenBytesCount{0};
+        /// @brief Written to the sink when the output is closed
+        std::string_view suffix;
+        /// @brief The layout of the logs, for JSON outputs
+        JsonFormat jsonFormat = JsonFormat::ARRAY;
+        /// @brief The layout of the logs for string outputs, `nullptr` for the built-in one
+        std::shared_ptr<const PatternLayout> layout;
+        /// @brief Which logs are written to this output
+        OutputFilter filter;
+    };
+
+    /// @brief An immutable snapshot of the outputs of one kind, replaced as a whole when the outputs change
+    using OutputList = std::vector<std::shared_ptr<Output>>;
+
+    /**
+     * @brief A logger or a `ScopedLogLevel` of the logger chain of a thread
+     */
+    struct ChainEntry {
+        /// @brief The logger or the `ScopedLogLevel` this entry was pushed by
+        const void* owner;
+        /// @brief The logger this entry was pushed by, `nullptr` for a `ScopedLogLevel`
+        Logger* logger;
+        LogLevel logLevel;
+        /// @brief The log level once resolved against the entries below, never `INHERIT`
+        LogLevel effectiveLogLevel;
+    };
+
+    /// @brief The loggers and `ScopedLogLevel`s of the current thread, as a hierarchy ; a fixed-size array, never allocated
+    inline static thread_local ChainEntry chain[TINYLOG_LOGGER_CHAIN_DEPTH];
+
+    /// @brief How many entries were pushed onto the chain of the current thread, possibly more than it can hold
+    inline static thread_local size_t chainSize = 0;
+
+    /// @brief The effective log level of the last entry in the chain of the current thread, `INHERIT` if the chain is empty
+    inline static thread_local LogLevel threadLogLevel = INHERIT;
+
+    /// @brief The current snapshot of outputs for the string logging, `nullptr` if there are none
+    inline static std::atomic<const OutputList*> stringOutputs{nullptr};
+
+    /// @brief Whether string logging is enabled
+    inline static std::atomic<bool> isStringOutputEnabled{false};
+
+    /// @brief The current snapshot of outputs for JSON logging, `nullptr` if there are none
+    inline static std::atomic<const OutputList*> jsonOutputs{nullptr};
+
+    /// @brief Whether JSON logging is enabled
+    inline static std::atomic<bool> isJsonOutputEnabled{false};
+
+    /// @brief The current snapshot of outputs for binary logging, `nullptr` if there are none
+    inline static std::atomic<const OutputList*> binaryOutputs{nullptr};
+
+    /// @brief Stands for "no output wants any log" in `outputsMinLogLevel`
+    static constexpr char noOutputLogLevel = static_cast<char>(FATAL) + 1;
+
+    /// @brief The lowest `OutputFilter::minLogLevel` of every output, below which no output wants a log
+    inline static std::atomic<char> outputsMinLogLevel{noOutputLogLevel};
+
+    class AsyncBackend;
+
+    /// @brief The asynchronous backend, if the asynchronous mode is enabled
+    inline static std::atomic<AsyncBackend*> asyncBackend{nullptr};
+
+    /// @brief Serializes the changes to the outputs and to the asynchronous mode. Never taken while logging.
+    inline static std::recursive_mutex configurationMutex;
+
+    /**
+     * @brief An output list replaced, or an asynchronous backend stopped, while other threads may still be reading it
+     */
+    struct RetiredResource {
+        /// @brief The epoch it was retired at : freed once every thread reading started at this epoch or later
+        std::uint64_t epoch;
+        std::unique_ptr<const OutputList> outputList;
+        std::unique_ptr<AsyncBackend> asyncBackend;
+    };
+
+    /// @brief The resources retired and not freed yet. Guarded by `configurationMutex`.
+    inline static std::vector<RetiredResource> retiredResources{};
+
+    /// @brief How many resources are in `retiredResources`, checked by the threads once they stop reading
+    inline static std::atomic<size_t> retiredResourcesCount{0};
+
+    /// @brief Incremented each time a resource is retired ; starts at 1, as 0 stands for "not reading"
+    inline static std::atomic<std::uint64_t> currentEpoch{1};
+
+    /**
+     * @brief The epoch a thread started reading the output lists and the asynchronous backend at, on its own cache line
+     */
+    struct alignas(64) ReaderEpoch {
+        ReaderEpoch() : epoch(0) {}
+
+        /// @brief 0 while the thread isn't reading
+        std::atomic<std::uint64_t> epoch;
+    };
+
+    /**
+     * @brief Owns the reader epoch of a thread, and unregisters it when the thread exits
+     */
+    struct ReaderEpochOwner {
+        ReaderEpochOwner() {
+            std::lock_guard<std::mutex> lock(readersMutex);
+            liveReaderEpochs.push_back(&readerEpoch);
+        }
+
+        ~ReaderEpochOwner() {
+            std::lock_guard<std::mutex> lock(readersMutex);
+            liveReaderEpochs.erase(std::find(liveReaderEpochs.begin(), liveReaderEpochs.end(), &readerEpoch));
+            // Logs from later thread-local destructors are counted in `unregisteredReadersCount`
+            threadReaderEpoch = &exitedReaderEpoch;
+        }
+
+        ReaderEpoch readerEpoch;
+    };
+
+    /**
+     * @brief Marks the current thread as reading the output lists and the asynchronous backend while it is alive, so
+     *      that the ones it is reading are only freed once it is done with them
+     * @note Can be nested : only the outermost guard of a thread enters and leaves the reading state.
+     */
+    class ReadGuard {
+    public:
+        ReadGuard() {
+            startReading();
+        }
+
+        ~ReadGuard() {
+            stopReading();
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    /// @brief Guards `liveReaderEpochs`
+    inline static std::mutex readersMutex;
+
+    /// @brief The reader epochs of the running threads
+    inline static std::vector<ReaderEpoch*> liveReaderEpochs{};
+
+    /// @brief Stands for the reader epoch of a thread that exited
+    inline static ReaderEpoch exitedReaderEpoch{};
+
+    /// @brief The reader epoch of `emergencyFlush()`, which must neither allocate nor lock to register one
+    inline static ReaderEpoch emergencyReaderEpoch{};
+
+    /// @brief How many threads are reading without a reader epoch of their own, as they are exiting
+    inline static std::atomic<long long> unregisteredReadersCount{0};
+
+    /// @brief The reader epoch of the current thread, `nullptr` until it reads for the first time
+    inline static thread_local ReaderEpoch* threadReaderEpoch = nullptr;
+
+    /// @brief How many `ReadGuard`s the current thread is in
+    inline static thread_local unsigned int threadReadDepth = 0;
+
+    /// @brief How many logs the stopped asynchronous backends dropped
+    inline static std::atomic<long long> retiredDroppedLogsCount{0};
+
+    /**
+     * @brief The counters of a thread, only written by this thread and read by `getMetrics()`
+     * @note As each thread counts on its own cache line, with plain loads and stores, counting never contends.
+     */
+    struct alignas(64) ThreadMetrics {
+        ThreadMetrics() : emittedCounts(), filteredCounts(), formattingNanoseconds(0), writingNanoseconds(0), timingCountdown(0) {}
+
+        std::atomic<long long> emittedCounts[LogMetrics::logLevelsCount];
+        std::atomic<long long> filteredCounts[LogMetrics::logLevelsCount];
+        std::atomic<long long> formattingNanoseconds;
+        std::atomic<long long> writingNanoseconds;
+        /// @brief How many logs to write before timing one
+        unsigned int timingCountdown;
+
+        /// @brief Adds to one of the counters of the current thread
+        static void add(std::atomic<long long>& counter, long long value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Owns the counters of a thread, and folds them into `retiredThreadMetrics` when the thread exits
+     */
+    struct ThreadMetricsOwner {
+        ThreadMetricsOwner() {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            liveThreadMetrics.push_back(&metrics);
+        }
+
+        ~ThreadMetricsOwner() {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            for (size_t i = 0; i < LogMetrics::logLevelsCount; i++) {
+                retiredThreadMetrics.emittedCounts[i].fetch_add(metrics.emittedCounts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                retiredThreadMetrics.filteredCounts[i].fetch_add(metrics.filteredCounts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            retiredThreadMetrics.formattingNanoseconds.fetch_add(metrics.formattingNanoseconds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            retiredThreadMetrics.writingNanoseconds.fetch_add(metrics.writingNanoseconds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            liveThreadMetrics.erase(std::find(liveThreadMetrics.begin(), liveThreadMetrics.end(), &metrics));
+            // Logs from later thread-local destructors are counted in the retired counters
+            threadMetrics = &retiredThreadMetrics;
+        }
+
+        ThreadMetrics metrics;
+    };
+
+    /// @brief Guards `liveThreadMetrics`, and the retirement of the counters of a thread
+    inline static std::mutex metricsMutex;
+
+    /// @brief The counters of the running threads
+    inline static std::vector<ThreadMetrics*> liveThreadMetrics{};
+
+    /// @brief The counters of the exited threads
+    inline static ThreadMetrics retiredThreadMetrics{};
+
+    /// @brief The counters of the current thread, `nullptr` until it counts something
+    inline static thread_local ThreadMetrics* threadMetrics = nullptr;
+
+    /// @brief How many times the outputs were flushed
+    inline static std::atomic<long long> flushesCount{0};
+
+    /// @brief The buffer the current thread formats its logs into, reused from log to log
+    inline static thread_local FormatBuffer formatBuffer{};
+
+    /// @brief The buffer the current thread formats the messages of its suppressed logs summaries into
+    inline static thread_local FormatBuffer summaryBuffer{};
+
+    /// @brief Set by the first `emergencyFlush()`
+    inline static std::atomic<bool> isEmergencyFlushed{false};
+
+    /// @brief The buffer the crash handler formats its log into, preallocated by `enableCrashHandler()`
+    inline static FormatBuffer emergencyBuffer{};
+
+#if TINYLOG_HAS_POSIX == 1
+    /// @brief A signal handled by the crash handler
+    struct CrashSignal {
+        int signalNumber;
+        struct sigaction previousAction;
+    };
+
+    static constexpr size_t maxCrashSignalsCount = 8;
+    inline static CrashSignal crashSignals[maxCrashSignalsCount]{};
+    inline static size_t crashSignalsCount = 0;
+
+    /// @brief The alternate stack the crash handler runs on, allocated once
+    static constexpr size_t crashStackSize = 64 * 1024;
+    inline static std::unique_ptr<char[]> crashStack;
+#endif
+
+    /// @brief The resolution of the timestamps in the logs
+    inline static std::atomic<TimestampPrecision> timestampPrecision{TimestampPrecision::SECONDS};
+
+    /**
+     * @brief The date and time part of the last timestamp formatted by a thread, reused as long as the following logs
+     *      happen during the same second.
+     */
+    struct TimestampCache {
+        long long second;
+        char dateTime[sizeof "1970-01-01T00:00:00"];
+    };
+
+    /// @brief The timestamp cache of the current thread
+    inline static thread_local TimestampCache timestampCache{-1, {}};
+
+    /// @brief The log level for this logger
+    LogLevel currentLogLevel;
+
+    /// @brief The log level for this logger once resolved against its parents, never `INHERIT`
+    LogLevel effectiveLogLevel;
+
+public:
+    /**
+     * @brief Creates a logger and appends it to the logger chain of the current thread.
+     * @param logLevel The log level of this logger, or `INHERIT` to use the one of its parent.
+     */
+    explicit Logger(LogLevel logLevel = INHERIT) {
+        currentLogLevel = logLevel;
+        effectiveLogLevel = pushChainEntry(this, this, logLevel);
+    }
+
+    /**
+     * @brief Removes the logger from the chain of the current thread.
+     * @note The outputs stay enabled, for the named loggers and the other threads : see `disableOutputs()`.
+     * @warning A logger must be destroyed by the thread that created it.
+     */
+    ~Logger() {
+        popChainEntry(this);
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Returns the log level for this logger, going back up the chain of loggers until one isn't set to INHERIT.
+     * @note If every logger in the chain's log level is set to `INHERIT` (including the top-most logger's), then the value
+     *      of the macro `TINYLOG_DEFAULT_LOG_LEVEL` is returned.
+     * @note The chain is the one of the calling thread : loggers created in other threads have no effect on it.
+     *      If the calling thread has no logger, only this logger's own log level is used.
+     * @note The level is resolved once, when the logger is created, so this function does not walk the chain.
+     * @returns A log level.
+     */
+    LogLevel getLogLevel() const {
+        LogLevel logLevel = threadLogLevel;
+        return (logLevel == INHERIT) ? effectiveLogLevel : logLevel;
+    }
+
+    /**
+     * @brief Returns whether a log of the given level would be logged
+     * @param givenLogLevel A log level
+     * @returns Whether `givenLogLevel` is kept at compile time, is at least the current log level, and is wanted by at
+     *      least one output.
+     * @note Cheap enough to be checked before building any expensive message or extras.
+     * @note A level found disabled is counted as a filtered log by the metrics, see `getMetrics()`.
+     */
+    bool isEnabledLogLevel(LogLevel givenLogLevel) const {
+        if (isCompiledLogLevel(givenLogLevel) && isLoggedLogLevel(givenLogLevel))
+            return true;
+        Logger::countFilteredLog(givenLogLevel);
+        return false;
+    }
+
+    /**
+     * @brief Logs the given message if the given log level is above the current log level
+     * @param givenLogLevel The log level for this log
+     * @param message The message to log
+     * @param extras An ensemble of strings to be displayed after the message
+     * @param filePath The path to the file where this function is called. Not displayed by default.
+     * @param lineNumber The line number of the file where this function is called. Not displayed by default.
+     * @note In asynchronous mode, the log is only captured here ; formatting and writing happen on the writer thread.
+     * @note Nothing is copied : once the buffers have grown to the size of the longest log, logging does not allocate.
+     */
+    void log(LogLevel givenLogLevel, std::string_view message, std::initializer_list<std::string_view> extras = {}, std::string_view filePath = "", int lineNumber = -1, bool showTimestamp = true) {
+        // Shortcut to exit the function if the log level does not match
+        if (!isLoggedLogLevel(givenLogLevel)) {
+            Logger::countFilteredLog(givenLogLevel);
+            return;
+        }
+
+        LogRecord record{givenLogLevel, LogClock::now(), showTimestamp, filePath, lineNumber, message, extras.begin(), extras.size()};
+        submit(record);
+    }
+
+    /**
+     * @brief Logs the given message along with typed fields, if the given log level is above the current log level
+     * @param givenLogLevel The log level for this log
+     * @param message The message to log
+     * @param firstField, otherFields The fields of the log, created with `field()`.
+     *      Example : `logger.log(TinyLog::INFO, "Request served", TinyLog::field("status", 200), TinyLog::field("cached", true))`
+     * @note The fields are formatted by the outputs only, e.g. as JSON numbers and booleans by the JSON outputs.
+     */
+    template <typename... Fields, std::enable_if_t<(std::is_same_v<Fields, Field> && ...), int> = 0>
+    void log(LogLevel givenLogLevel, std::string_view message, const Field& firstField, const Fields&... otherFields) {
+        if (!isLoggedLogLevel(givenLogLevel)) {
+            Logger::countFilteredLog(givenLogLevel);
+            return;
+        }
+
+        const Field fields[] = {firstField, otherFields...};
+        LogRecord record{givenLogLevel, LogClock::now(), true, "", -1, message, nullptr, 0, nullptr, fields, sizeof...(otherFields) + 1};
+        submit(record);
+    }
+
+    /**
+     * @brief Logs the given message from the given call site, see the other versions of `log()`.
+     * @param callSite The call site of this log, giving its log level, file path and line number. Must outlive the
+     *      logs, as the logging macros' static call sites do.
+     * @note Used by the logging macros.
+     */
+    void log(CallSite& callSite, std::string_view message, std::initializer_list<std::string_view> extras = {}) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        logFromCallSite(callSite, message, extras);
+    }
+
+    /**
+     * @brief Logs the given message along with typed fields from the given call site, see the other versions of `log()`.
+     * @note Used by the `TinyLog_logf` macro.
+     */
+    template <typename... Fields, std::enable_if_t<(std::is_same_v<Fields, Field> && ...), int> = 0>
+    void log(CallSite& callSite, std::string_view message, const Field& firstField, const Fields&... otherFields) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        const Field fields[] = {firstField, otherFields...};
+        logFromCallSite(callSite, message, fields, sizeof...(otherFields) + 1);
+    }
+
+    /**
+     * @brief Logs the given message, see the non-template version of `log()`.
+     * @tparam givenLogLevel The log level for this log. If it is below `TINYLOG_COMPILE_MIN_LEVEL`, this call compiles to nothing.
+     */
+    template <LogLevel givenLogLevel>
+    void log(std::string_view message, std::initializer_list<std::string_view> extras = {}, std::string_view filePath = "", int lineNumber = -1, bool showTimestamp = true) {
+        if constexpr (isCompiledLogLevel(givenLogLevel)) {
+            log(givenLogLevel, message, extras, filePath, lineNumber, showTimestamp);
+        }
+    }
+
+    /**
+     * @brief Enables logging to a given stream, as a string output.
+     * @param outputStream An output stream for the logging. Example : std::cout
+     * @param filter Which logs are written to this output, every log by default
+     * @param layout The layout of the logs, e.g. `"%t %L %f:%l %m"` ; the built-in one by default
+     */
+    static void enableStringOutput(std::ostream& outputStream, const OutputFilter& filter = {}, const PatternLayout& layout = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        isStringOutputEnabled.store(true, std::memory_order_release);
+        addStringOutput(outputStream, filter, layout);
+    }
+
+    /**
+     * @brief Enables logging to a given sink, as a string output.
+     * @param sink A sink for the logging. Must outlive the string output.
+     * @param filter Which logs are written to this output, every log by default
+     * @param layout The layout of the logs, e.g. `"%t %L %f:%l %m"` ; the built-in one by default
+     */
+    static void enableStringOutput(Sink& sink, const OutputFilter& filter = {}, const PatternLayout& layout = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        isStringOutputEnabled.store(true, std::memory_order_release);
+        addStringOutput(sink, filter, layout);
+    }
+
+    /**
+     * @bref Adds another output stream to the string output.
+     * @param outputStream An output stream for the logging. Example : std::cout
+     * @param filter Which logs are written to this output, every log by default
+     * @param layout The layout of the logs, e.g. `"%t %L %f:%l %m"` ; the built-in one by default
+     */
+    static void addStringOutput(std::ostream& outputStream, const OutputFilter& filter = {}, const PatternLayout& layout = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        assert(isStringOutputEnabled);
+        flush();
+        addStringOutput(std::make_shared<Output>(std::make_unique<OstreamSink>(outputStream)), filter, layout);
+    }
+
+    /**
+     * @bref Adds another sink to the string output.
+     * @param sink A sink for the logging. Must outlive the string output.
+     * @param filter Which logs are written to this output, every log by default
+     * @param layout The layout of the logs, e.g. `"%t %L %f:%l %m"` ; the built-in one by default
+     */
+    static void addStringOutput(Sink& sink, const OutputFilter& filter = {}, const PatternLayout& layout = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        assert(isStringOutputEnabled);
+        flush();
+        addStringOutput(std::make_shared<Output>(sink), filter, layout);
+    }
+
+    /**
+     * @brief Disables logging as a string output.
+     * @warning Clears the previous output streams with no further processing.
+     * @note In asynchronous mode, the pending logs are written before the streams are removed.
+     */
+    static void disableStringOutput() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        isStringOutputEnabled.store(false, std::memory_order_release);
+        closeOutputs(stringOutputs);
+    }
+
+    /**
+     * @brief Enables logging to a given stream, as a JSON output.
+     * @param outputStream An output stream for the logging. Example : std::cout
+     * @param jsonFormat The layout of the logs : a single JSON array by default, or one JSON object per line
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void enableJsonOutput(std::ostream& outputStream, JsonFormat jsonFormat = JsonFormat::ARRAY, const OutputFilter& filter = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        isJsonOutputEnabled.store(true, std::memory_order_release);
+        addJsonOutput(outputStream, jsonFormat, filter);
+    }
+
+    /**
+     * @brief Enables logging to a given sink, as a JSON output.
+     * @param sink A sink for the logging. Must outlive the JSON output.
+     * @param jsonFormat The layout of the logs : a single JSON array by default, or one JSON object per line
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void enableJsonOutput(Sink& sink, JsonFormat jsonFormat = JsonFormat::ARRAY, const OutputFilter& filter = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        isJsonOutputEnabled.store(true, std::memory_order_release);
+        addJsonOutput(sink, jsonFormat, filter);
+    }
+
+    /**
+     * @bref Adds another output stream to the JSON output.
+     * @param outputStream An output stream for the logging. Example : std::cout
+     * @param jsonFormat The layout of the logs : a single JSON array by default, or one JSON object per line
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void addJsonOutput(std::ostream& outputStream, JsonFormat jsonFormat = JsonFormat::ARRAY, const OutputFilter& filter = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        assert(isJsonOutputEnabled);
+        flush();
+        addJsonOutput(std::make_shared<Output>(std::make_unique<OstreamSink>(outputStream)), jsonFormat, filter);
+    }
+
+    /**
+     * @bref Adds another sink to the JSON output.
+     * @param sink A sink for the logging. Must outlive the JSON output.
+     * @param jsonFormat The layout of the logs : a single JSON array by default, or one JSON object per line
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void addJsonOutput(Sink& sink, JsonFormat jsonFormat = JsonFormat::ARRAY, const OutputFilter& filter = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        assert(isJsonOutputEnabled);
+        flush();
+        addJsonOutput(std::make_shared<Output>(sink), jsonFormat, filter);
+    }
+
+    /**
+     * @brief Disables logging as a JSON output.
+     * @warning Clears the previous output streams with minor processing : closes the arrays of the `ARRAY` outputs.
+     * @note In asynchronous mode, the pending logs are written before the streams are removed.
+     */
+    static void disableJsonOutput() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        isJsonOutputEnabled.store(false, std::memory_order_release);
+        closeOutputs(jsonOutputs);
+    }
+
+    /**
+     * @brief Enables logging to a given binary sink, in the compact binary format.
+     * @param sink A binary sink for the logging. Must outlive the binary output.
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void enableBinaryOutput(BinarySink& sink, const OutputFilter& filter = {}) {
+        addBinaryOutput(sink, filter);
+    }
+
+    /**
+     * @brief Adds another binary sink to the binary output.
+     * @param sink A binary sink for the logging. Must outlive the binary output.
+     * @param filter Which logs are written to this output, every log by default
+     */
+    static void addBinaryOutput(BinarySink& sink, const OutputFilter& filter = {}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        addOutput(binaryOutputs, std::make_shared<Output>(sink), filter);
+    }
+
+    /**
+     * @brief Disables logging to binary sinks.
+     * @note In asynchronous mode, the pending logs are written before the sinks are removed.
+     */
+    static void disableBinaryOutput() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        flush();
+        closeOutputs(binaryOutputs);
+    }
+
+    /**
+     * @brief Logs the pending summaries of the suppressed logs, then disables every string, JSON and binary output,
+     *      closing the JSON arrays.
+     * @note The outputs don't depend on any logger being alive : call it before the output streams and sinks are
+     *      destroyed, e.g. at the end of `main()`.
+     */
+    static void disableOutputs() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        reportSuppressedLogs();
+        disableStringOutput();
+        disableJsonOutput();
+        disableBinaryOutput();
+    }
+
+    /**
+     * @brief Returns whether the string output is enabled
+     * @note This function should be marked as const, but is a static function.
+     * @returns Whether the string output is enabled.
+     */
+    static bool isEnabledStringOutput() {
+        return isStringOutputEnabled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Formerly pre-allocated enough space for n loggers in the chain of the current thread
+     * @param capacity The logger chain capacity needed, which must not exceed `TINYLOG_LOGGER_CHAIN_DEPTH`. An assertion
+     *      will check that.
+     * @deprecated The logger chain is now a fixed-size array of `TINYLOG_LOGGER_CHAIN_DEPTH` entries, never allocated.
+     */
+    [[deprecated("The logger chain holds TINYLOG_LOGGER_CHAIN_DEPTH loggers, set this macro instead")]]
+    static void setLoggerChainCapacity(size_t capacity) {
+        assert(capacity <= TINYLOG_LOGGER_CHAIN_DEPTH);
+        (void)capacity;
+    }
+
+    /**
+     * @brief Enables the asynchronous mode : `log()` only captures the log into a bounded lock-free queue, and a dedicated
+     *      writer thread does the formatting and writes to the outputs.
+     * @param queueDepth The amount of logs the queue can hold, per thread with `AsyncQueueMode::PER_THREAD`. Rounded up
+     *      to the next power of two.
+     * @param overflowPolicy What to do when a log is sent while the queue is full. With `AsyncQueueMode::PER_THREAD`,
+     *      `DROP_OLDEST` acts as `DROP_NEWEST`, as only the writer thread reads a queue.
+     * @param queueMode Whether every thread shares a single queue, or has its own. With a queue per thread, logging
+     *      threads never write to the same cache lines, and the writer thread merges the queues by timestamp.
+     * @note Calling it while the asynchronous mode is already enabled drains the previous queue first.
+     * @warning The output streams must stay alive until `disableAsyncMode()` or `flush()` returns.
+     */
+    static void enableAsyncMode(size_t queueDepth = TINYLOG_ASYNC_DEFAULT_QUEUE_DEPTH, AsyncOverflowPolicy overflowPolicy = AsyncOverflowPolicy::BLOCK,
+                                AsyncQueueMode queueMode = AsyncQueueMode::SHARED) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        disableAsyncMode();
+        asyncBackend.store(new AsyncBackend(queueDepth, overflowPolicy, queueMode), std::memory_order_release);
+    }
+
+    /**
+     * @brief Writes every pending log, stops the writer thread and goes back to synchronous logging.
+     * @note Logs sent concurrently by other threads while this function runs may be lost.
+     */
+    static void disableAsyncMode() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        AsyncBackend* backend = asyncBackend.exchange(nullptr, std::memory_order_acq_rel);
+        if (backend == nullptr)
+            return;
+        backend->stop();
+        retiredDroppedLogsCount.fetch_add(static_cast<long long>(backend->getDroppedCount()), std::memory_order_relaxed);
+        retire({0, nullptr, std::unique_ptr<AsyncBackend>(backend)});
+    }
+
+    /**
+     * @brief Returns whether the asynchronous mode is enabled
+     * @returns Whether the asynchronous mode is enabled.
+     */
+    static bool isEnabledAsyncMode() {
+        return asyncBackend.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * @brief In asynchronous mode, blocks until every log sent before this call has been written, then flushes the outputs.
+     *      In synchronous mode, only flushes the outputs.
+     */
+    static void flush() {
+        ReadGuard guard;
+        if (AsyncBackend* backend = asyncBackend.load(std::memory_order_acquire)) {
+            backend->flush();
+            return;
+        }
+        flushOutputs();
+    }
+
+    /**
+     * @brief Writes everything still pending to the outputs, when the process is about to die. Called by the crash handler.
+     * @note In asynchronous mode, waits up to `TINYLOG_EMERGENCY_FLUSH_TIMEOUT_MS` for the writer thread to write the
+     *      queued logs and flush the outputs. Then writes the buffered data of each sink with `Sink::emergencyWrite()`,
+     *      and closes the JSON arrays, whose outputs are no longer written to afterwards.
+     * @note Async-signal-safe, as long as the sinks are : it neither allocates nor locks, formats into a preallocated
+     *      buffer it truncates the log to, and only makes a single attempt at each output, skipping the ones being
+     *      written when the signal arrived. The outputs it wrote to are no longer written to afterwards. Only does
+     *      something the first time.
+     * @note Best effort in asynchronous mode : the writer thread runs regular code, which allocates and locks, so the
+     *      queued logs are lost if it can't make progress before the timeout, e.g. if the interrupted thread holds a
+     *      lock it needs.
+     */
+    static void emergencyFlush() {
+        emergencyFlush(nullptr);
+    }
+
+#if TINYLOG_HAS_POSIX == 1
+    /**
+     * @brief Installs a handler logging a `FATAL` log and calling `emergencyFlush()` when the process receives one of
+     *      the given signals, before letting the previous handler of the signal (by default, the one killing the
+     *      process) handle it.
+     * @param signalNumbers The signals to handle, at most 8
+     * @note The handler runs on an alternate stack, so that it can handle stack overflows ; only in the calling thread,
+     *      as each thread has its own alternate stack.
+     * @note The log of the crash is formatted into a buffer of `TINYLOG_EMERGENCY_BUFFER_SIZE` bytes, preallocated here,
+     *      and truncated to it. It isn't written to binary outputs, which allocate to encode a log.
+     * @returns Whether the handler is installed for every signal.
+     */
+    static bool enableCrashHandler(std::initializer_list<int> signalNumbers = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL}) {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        disableCrashHandler();
+        emergencyBuffer.reserveFixed(TINYLOG_EMERGENCY_BUFFER_SIZE);
+
+        if (crashStack == nullptr) {
+            crashStack = std::make_unique<char[]>(crashStackSize);
+            stack_t stack{};
+            stack.ss_sp = crashStack.get();
+            stack.ss_size = crashStackSize;
+            ::sigaltstack(&stack, nullptr);
+        }
+
+        struct sigaction action {};
+        action.sa_handler = &onCrashSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_ONSTACK;
+        bool isInstalled = true;
+        for (int signalNumber : signalNumbers) {
+            if (crashSignalsCount == maxCrashSignalsCount) {
+                isInstalled = false;
+                break;
+            }
+            CrashSignal& crashSignal = crashSignals[crashSignalsCount];
+            if (::sigaction(signalNumber, &action, &crashSignal.previousAction) != 0) {
+                isInstalled = false;
+                continue;
+            }
+            crashSignal.signalNumber = signalNumber;
+            crashSignalsCount++;
+        }
+        return isInstalled;
+    }
+
+    /**
+     * @brief Restores the previous handlers of the signals handled by the crash handler
+     */
+    static void disableCrashHandler() {
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        for (size_t i = 0; i < crashSignalsCount; i++) {
+            ::sigaction(crashSignals[i].signalNumber, &crashSignals[i].previousAction, nullptr);
+        }
+        crashSignalsCount = 0;
+    }
+#endif
+
+    /**
+     * @brief Logs a summary of the logs suppressed by the sampling or the rate limit of each registered call site, such
+     *      as "Suppressed 12345 messages from main.cpp:42", if any were suppressed since its last summary.
+     * @note Otherwise, a call site only logs its summary along with its next log, at most every
+     *      `TINYLOG_SUPPRESSED_SUMMARY_INTERVAL_MS` ; call this periodically so that call sites that stopped logging get
+     *      their summary too. Called by `disableOutputs()`.
+     */
+    static void reportSuppressedLogs() {
+        CallSite::forEach([](CallSite& callSite) {
+            logSuppressedSummary(callSite, true);
+        });
+    }
+
+    /**
+     * @brief Sets the resolution of the timestamps in the logs
+     * @param precision The new resolution. `TimestampPrecision::SECONDS` by default.
+     */
+    static void setTimestampPrecision(TimestampPrecision precision) {
+        timestampPrecision.store(precision, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the resolution of the timestamps in the logs
+     * @returns The current timestamp precision.
+     */
+    static TimestampPrecision getTimestampPrecision() {
+        return timestampPrecision.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns how many logs have been discarded by the overflow policy of the asynchronous mode
+     * @returns The amount of dropped logs since the asynchronous mode was enabled, or 0 if it is disabled.
+     */
+    static unsigned long long getDroppedLogsCount() {
+        ReadGuard guard;
+        AsyncBackend* backend = asyncBackend.load(std::memory_order_acquire);
+        return backend ? backend->getDroppedCount() : 0;
+    }
+
+    /**
+     * @brief Returns a snapshot of the counters TinyLog keeps about itself : logs emitted and filtered per log level,
+     *      bytes written per output, state of the asynchronous queue, dropped logs, flushes, and time spent formatting
+     *      and writing.
+     * @note The counters are relaxed atomics owned by each thread : counting is cheap enough to be always on, and this
+     *      function sums them. The counts of logs being logged concurrently may be missed until the next snapshot.
+     */
+    static LogMetrics getMetrics() {
+        LogMetrics metrics;
+        auto addThreadMetrics = [&metrics](const ThreadMetrics& counters) {
+            for (size_t i = 0; i < LogMetrics::logLevelsCount; i++) {
+                metrics.emittedCounts[i] += counters.emittedCounts[i].load(std::memory_order_relaxed);
+                metrics.filteredCounts[i] += counters.filteredCounts[i].load(std::memory_order_relaxed);
+            }
+            metrics.formattingTime += std::chrono::nanoseconds(counters.formattingNanoseconds.load(std::memory_order_relaxed));
+            metrics.writingTime += std::chrono::nanoseconds(counters.writingNanoseconds.load(std::memory_order_relaxed));
+        };
+        {
+            std::lock_guard<std::mutex> lock(metricsMutex);
+            addThreadMetrics(retiredThreadMetrics);
+            for (const ThreadMetrics* counters : liveThreadMetrics) {
+                addThreadMetrics(*counters);
+            }
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(configurationMutex);
+        metrics.droppedCount = retiredDroppedLogsCount.load(std::memory_order_relaxed);
+        metrics.flushesCount = flushesCount.load(std::memory_order_relaxed);
+        if (AsyncBackend* backend = asyncBackend.load(std::memory_order_acquire)) {
+            metrics.droppedCount += static_cast<long long>(backend->getDroppedCount());
+            metrics.queueDepth = backend->getQueueDepth();
+            metrics.queueHighWaterMark = backend->getQueueHighWaterMark();
+        }
+        std::pair<std::string_view, const std::atomic<const OutputList*>*> outputLists[] = {
+            {"string", &stringOutputs}, {"json", &jsonOutputs}, {"binary", &binaryOutputs}};
+        for (const auto& [format, outputs] : outputLists) {
+            const OutputList* outputList = outputs->load(std::memory_order_acquire);
+            if (outputList == nullptr)
+                continue;
+            for (const std::shared_ptr<Output>& output : *outputList) {
+                metrics.outputs.push_back({format, output->sink, output->writtenCount.load(std::memory_order_relaxed),
+                                           output->writtenBytesCount.load(std::memory_order_relaxed)});
+            }
+        }
+        return metrics;
+    }
+
+private:
+    /**
+     * @brief Resolves a log level against the one of its parent in the chain.
+     * @param logLevel A log level, possibly `INHERIT`.
+     * @param parentLogLevel The effective log level of the parent, `INHERIT` for the top-most entry.
+     * @returns `logLevel` if it isn't `INHERIT`, otherwise the effective log level of the parent, or
+     *      `TINYLOG_DEFAULT_LOG_LEVEL` if there is none.
+     */
+    static LogLevel resolveLogLevel(LogLevel logLevel, LogLevel parentLogLevel) {
+        if (logLevel != INHERIT)
+            return logLevel;
+        return (parentLogLevel == INHERIT) ? TINYLOG_DEFAULT_LOG_LEVEL : parentLogLevel;
+    }
+
+    /**
+     * @brief Pushes an entry onto the logger chain of the current thread
+     * @param owner The logger or the `ScopedLogLevel` pushing the entry
+     * @param logger The logger pushing the entry, `nullptr` for a `ScopedLogLevel`
+     * @returns The effective log level of the entry.
+     * @warning Beyond `TINYLOG_LOGGER_CHAIN_DEPTH` entries, the entry is counted but not kept : its log level has no effect.
+     *      An assertion checks that.
+     */
+    static LogLevel pushChainEntry(const void* owner, Logger* logger, LogLevel logLevel) {
+        LogLevel effective = resolveLogLevel(logLevel, threadLogLevel);
+        assert(chainSize < TINYLOG_LOGGER_CHAIN_DEPTH && "The logger chain is full, raise TINYLOG_LOGGER_CHAIN_DEPTH");
+        if (chainSize < TINYLOG_LOGGER_CHAIN_DEPTH) {
+            chain[chainSize] = ChainEntry{owner, logger, logLevel, effective};
+            threadLogLevel = effective;
+        }
+        chainSize++;
+        return effective;
+    }
+
+    /**
+     * @brief Removes the entry of the given owner from the logger chain of the current thread
+     * @note If the entry isn't the last one, the entries after it get a new parent, and are resolved against it.
+     */
+    static void popChainEntry(const void* owner) {
+        assert(chainSize > 0);
+        size_t keptSize = std::min<size_t>(chainSize, TINYLOG_LOGGER_CHAIN_DEPTH);
+        chainSize--;
+        size_t position = keptSize;
+        while (position > 0 && chain[position - 1].owner != owner)
+            position--;
+        if (position == 0)
+            return;  // Beyond the depth of the chain, the entry was never kept
+
+        // Not removed in reverse order of creation : the entries pushed after this one get a new parent
+        for (size_t next = position; next < keptSize; next++) {
+            ChainEntry& entry = chain[next - 1];
+            entry = chain[next];
+            entry.effectiveLogLevel = resolveLogLevel(entry.logLevel, (next >= 2) ? chain[next - 2].effectiveLogLevel : INHERIT);
+            if (entry.logger != nullptr)
+                entry.logger->effectiveLogLevel = entry.effectiveLogLevel;
+        }
+        keptSize--;
+        threadLogLevel = (keptSize == 0) ? INHERIT : chain[keptSize - 1].effectiveLogLevel;
+    }
+
+    /**
+     * @brief A log captured by `log()` in asynchronous mode, waiting to be written by the writer thread.
+     * @note Records are reused from slot to slot, so their storage keeps its capacity and steady-state logging
+     *      does not allocate.
+     */
+    struct AsyncRecord {
+        LogLevel logLevel = INFO;
+        LogClock::time_point timestamp{};
+        bool showTimestamp = true;
+        int lineNumber = -1;
+        const CallSite* callSite = nullptr;
+        /// @brief The file path (unless the log has a call site, which holds it), the message, the extras, then the key
+        ///     and the string value of each field, one after the other
+        std::string text;
+        size_t filePathSize = 0;
+        size_t messageSize = 0;
+        std::vector<size_t> extraSizes;
+        /// @brief The fields, then the fields of the context, whose key and string value only hold their size, their
+        ///     characters being in `text`
+        std::vector<Field> fields;
+        size_t contextFieldsCount = 0;
+
+        /// @brief Copies the given log into this record
+        void assign(const LogRecord& record) {
+            logLevel = record.logLevel;
+            timestamp = record.timestamp;
+            showTimestamp = record.showTimestamp;
+            lineNumber = record.lineNumber;
+            callSite = record.callSite;
+            text.clear();
+            if (callSite == nullptr)
+                text.append(record.filePath);
+            text.append(record.message);
+            filePathSize = (callSite == nullptr) ? record.filePath.size() : 0;
+            messageSize = record.message.size();
+            extraSizes.resize(record.extrasCount);
+            for (size_t i = 0; i < record.extrasCount; i++) {
+                text.append(record.extras[i]);
+                extraSizes[i] = record.extras[i].size();
+            }
+            fields.assign(record.fields, record.fields + record.fieldsCount);
+            fields.insert(fields.end(), record.contextFields, record.contextFields + record.contextFieldsCount);
+            contextFieldsCount = record.contextFieldsCount;
+            for (Field& field : fields) {
+                text.append(field.key);
+                text.append(field.string);
+                field.key = std::string_view(nullptr, field.key.size());
+                field.string = std::string_view(nullptr, field.string.size());
+            }
+        }
+
+        /**
+         * @brief Returns a view over this record
+         * @param extraViews Where to store the views over the extras, kept alive by the caller
+         * @param fieldViews Where to store the fields, kept alive by the caller
+         */
+        LogRecord view(std::vector<std::string_view>& extraViews, std::vector<Field>& fieldViews) const {
+            std::string_view textView = text;
+            size_t offset = filePathSize + messageSize;
+            extraViews.clear();
+            for (size_t extraSize : extraSizes) {
+                extraViews.push_back(textView.substr(offset, extraSize));
+                offset += extraSize;
+            }
+            fieldViews.assign(fields.begin(), fields.end());
+            for (Field& field : fieldViews) {
+                field.key = textView.substr(offset, field.key.size());
+                offset += field.key.size();
+                field.string = textView.substr(offset, field.string.size());
+                offset += field.string.size();
+            }
+            std::string_view filePath = (callSite == nullptr) ? textView.substr(0, filePathSize) : callSite->filePath;
+            size_t fieldsCount = fieldViews.size() - contextFieldsCount;
+            return LogRecord{logLevel, timestamp, showTimestamp, filePath, lineNumber, textView.substr(filePathSize, messageSize),
+                             extraViews.data(), extraViews.size(), callSite, fieldViews.data(), fieldsCount,
+                             fieldViews.data() + fieldsCount, contextFieldsCount};
+        }
+    };
+
+    /**
+     * @brief Bounded lock-free queue, where each cell holds a sequence number telling producers and consumers whose
+     *      turn it is to use it (Dmitry Vyukov's bounded queue).
+     * @note Supports any amount of producers and consumers ; the consumers are the writer thread and, with the
+     *      `DROP_OLDEST` policy, the producers discarding the oldest log.
+     */
+    class AsyncQueue {
+    public:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            AsyncRecord record;
+        };
+
+        explicit AsyncQueue(size_t depth) {
+            size_t capacity = 2;
+            while (capacity < depth)
+                capacity <<= 1;
+            mask = capacity - 1;
+            cells = std::make_unique<Cell[]>(capacity);
+            for (size_t i = 0; i < capacity; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Reserves a cell to write a record into. `commitPush()` must be called once the record is filled.
+         * @returns The reserved cell, or `nullptr` if the queue is full.
+         */
+        Cell* tryReservePush(size_t& position) {
+            return tryReserve(enqueuePosition, position, 0);
+        }
+
+        void commitPush(Cell* cell, size_t position) {
+            cell->sequence.store(position + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Reserves the oldest cell to read a record from. `commitPop()` must be called once the record is used.
+         * @returns The reserved cell, or `nullptr` if the queue is empty.
+         */
+        Cell* tryReservePop(size_t& position) {
+            return tryReserve(dequeuePosition, position, 1);
+        }
+
+        void commitPop(Cell* cell, size_t position) {
+            cell->sequence.store(position + mask + 1, std::memory_order_release);
+        }
+
+        /// @brief Returns the amount of pushes reserved so far
+        size_t getPushedCount() const {
+            return enqueuePosition.load(std::memory_order_acquire);
+        }
+
+    private:
+        Cell* tryReserve(std::atomic<size_t>& sharedPosition, size_t& position, size_t expectedOffset) {
+            position = sharedPosition.load(std::memory_order_relaxed);
+            while (true) {
+                Cell* cell = &cells[position & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + expectedOffset);
+                if (difference == 0) {
+                    if (sharedPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        return cell;
+                } else if (difference < 0) {
+                    return nullptr;
+                } else {
+                    position = sharedPosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> enqueuePosition{0};
+        alignas(64) std::atomic<size_t> dequeuePosition{0};
+    };
+
+    /**
+     * @brief Bounded lock-free queue with a single producer and a single consumer, used by a single logging thread.
+     * @note The producer and the consumer each own a cache line, holding their position and a cached copy of the other's
+     *      position : they only read each other's line when the cached copy says the queue is full or empty.
+     */
+    class ThreadQueue {
+    public:
+        explicit ThreadQueue(size_t depth) {
+            size_t capacity = 2;
+            while (capacity < depth)
+                capacity <<= 1;
+            mask = capacity - 1;
+            records = std::make_unique<AsyncRecord[]>(capacity);
+        }
+
+        /**
+         * @brief Returns the record to write the next log into, `commitPush()` must be called once it is filled
+         * @returns The record, or `nullptr` if the queue is full.
+         */
+        AsyncRecord* tryReservePush() {
+            size_t position = pushPosition.load(std::memory_order_relaxed);
+            if (position - cachedPopPosition > mask) {
+                cachedPopPosition = popPosition.load(std::memory_order_acquire);
+                if (position - cachedPopPosition > mask)
+                    return nullptr;
+            }
+            return &records[position & mask];
+        }
+
+        void commitPush() {
+            pushPosition.store(pushPosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Returns the oldest record of the queue, `commitPop()` must be called once it is used
+         * @returns The record, or `nullptr` if the queue is empty.
+         */
+        const AsyncRecord* tryPeek() {
+            size_t position = popPosition.load(std::memory_order_relaxed);
+            if (position == cachedPushPosition) {
+                cachedPushPosition = pushPosition.load(std::memory_order_acquire);
+                if (position == cachedPushPosition)
+                    return nullptr;
+            }
+            return &records[position & mask];
+        }
+
+        void commitPop() {
+            popPosition.store(popPosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        size_t getPushedCount() const {
+            return pushPosition.load(std::memory_order_acquire);
+        }
+
+        size_t getPoppedCount() const {
+            return popPosition.load(std::memory_order_acquire);
+        }
+
+        /// @brief Whether a thread logs into this queue ; cleared when the thread exits, so that another thread can reuse it
+        std::atomic<bool> isOwned{true};
+        /// @brief The next queue of the backend, set before the queue is published
+        ThreadQueue* next = nullptr;
+
+    private:
+        std::unique_ptr<AsyncRecord[]> records;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> pushPosition{0};
+        size_t cachedPopPosition = 0;
+        alignas(64) std::atomic<size_t> popPosition{0};
+        size_t cachedPushPosition = 0;
+    };
+
+    /**
+     * @brief Owns the queue and the writer thread of the asynchronous mode.
+     */
+    class AsyncBackend {
+    public:
+        AsyncBackend(size_t queueDepth, AsyncOverflowPolicy overflowPolicy, AsyncQueueMode queueMode) :
+            queue(queueMode == AsyncQueueMode::SHARED ? queueDepth : 1), overflowPolicy(overflowPolicy), queueMode(queueMode),
+            threadQueueDepth(queueDepth), writerThread([this]() { run(); }) {}
+
+        ~AsyncBackend() {
+            stop();
+        }
+
+        /**
+         * @brief Writes the pending logs and joins the writer thread. Logs pushed afterwards are discarded.
+         */
+        void stop() {
+            if (!writerThread.joinable())
+                return;
+            stopRequested.store(true, std::memory_order_release);
+            wakeWriter();
+            writerThread.join();
+        }
+
+        void push(const LogRecord& record) {
+            if (queueMode == AsyncQueueMode::PER_THREAD) {
+                pushToThreadQueue(record);
+                return;
+            }
+
+            size_t position;
+            AsyncQueue::Cell* cell;
+            while ((cell = queue.tryReservePush(position)) == nullptr) {
+                if (stopRequested.load(std::memory_order_acquire)) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (overflowPolicy == AsyncOverflowPolicy::DROP_NEWEST) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (overflowPolicy == AsyncOverflowPolicy::DROP_OLDEST) {
+                    size_t oldestPosition;
+                    AsyncQueue::Cell* oldest = queue.tryReservePop(oldestPosition);
+                    if (oldest != nullptr) {
+                        queue.commitPop(oldest, oldestPosition);
+                        droppedCount.fetch_add(1, std::memory_order_relaxed);
+                        processedCount.fetch_add(1, std::memory_order_release);
+                    }
+                    continue;
+                }
+                wakeWriter();
+                std::this_thread::yield();
+            }
+
+            cell->record.assign(record);
+            queue.commitPush(cell, position);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (isWriterSleeping.load(std::memory_order_relaxed))
+                wakeWriter();
+        }
+
+        void flush() {
+            // The writer thread can't wait for itself, e.g. when an output filter logs a FATAL log
+            if (stopRequested.load(std::memory_order_acquire) || std::this_thread::get_id() == writerThreadId.load(std::memory_order_acquire))
+                return;
+            if (queueMode == AsyncQueueMode::PER_THREAD) {
+                wakeWriter();
+                for (ThreadQueue* threadQueue = threadQueues.load(std::memory_order_acquire); threadQueue != nullptr; threadQueue = threadQueue->next) {
+                    size_t target = threadQueue->getPushedCount();
+                    while (threadQueue->getPoppedCount() < target && !isWriterStopped.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                }
+            } else {
+                size_t target = queue.getPushedCount();
+                wakeWriter();
+                while (processedCount.load(std::memory_order_acquire) < target && !isWriterStopped.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            }
+
+            // The backend may be stopped concurrently : the writer thread is then gone, and won't serve the request
+            unsigned long long request = flushRequests.fetch_add(1, std::memory_order_acq_rel) + 1;
+            wakeWriter();
+            while (flushesDone.load(std::memory_order_acquire) < request && !isWriterStopped.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        /**
+         * @brief Waits until the writer thread has written the pending logs and flushed the outputs, or until the deadline
+         * @note Async-signal-safe : only asks the writer thread for a flush, without waking it up, then polls an atomic,
+         *      sleeping with `poll(2)` and reading the clock with `clock_gettime(2)`. Whether the writer thread gets
+         *      there in time is best effort : it runs regular code, which allocates and locks, and may wait for a lock
+         *      held by the interrupted thread. Returns right away if called from the writer thread or if it is stopping.
+         */
+        void drainUntil(std::chrono::steady_clock::time_point deadline) {
+            if (stopRequested.load(std::memory_order_acquire) || std::this_thread::get_id() == writerThreadId.load(std::memory_order_acquire))
+                return;
+            unsigned long long request = flushRequests.fetch_add(1, std::memory_order_acq_rel) + 1;
+            while (flushesDone.load(std::memory_order_acquire) < request && !isWriterStopped.load(std::memory_order_acquire)
+                   && std::chrono::steady_clock::now() < deadline) {
+#if TINYLOG_HAS_POSIX == 1
+                ::poll(nullptr, 0, 1);
+#else
+                std::this_thread::yield();
+#endif
+            }
+        }
+
+        unsigned long long getDroppedCount() const {
+            return droppedCount.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Returns how many logs are waiting to be written
+        size_t getQueueDepth() const {
+            if (queueMode == AsyncQueueMode::SHARED) {
+                size_t pushedCount = queue.getPushedCount();
+                size_t writtenCount = processedCount.load(std::memory_order_acquire);
+                return pushedCount > writtenCount ? pushedCount - writtenCount : 0;
+            }
+            size_t depth = 0;
+            for (ThreadQueue* threadQueue = threadQueues.load(std::memory_order_acquire); threadQueue != nullptr; threadQueue = threadQueue->next) {
+                depth += threadQueue->getPushedCount() - threadQueue->getPoppedCount();
+            }
+            return depth;
+        }
+
+        /// @brief Returns the most logs that were waiting to be written, each time the writer thread started writing
+        size_t getQueueHighWaterMark() const {
+            return queueHighWaterMark.load(std::memory_order_relaxed);
+        }
+
+    private:
+        /**
+         * @brief The queue of the current thread, along with the backend it belongs to
+         * @note Gives the queue back when the thread exits. Holds a reference to it, as the backend may be gone by then.
+         */
+        struct ThreadQueueHandle {
+            ThreadQueueHandle() : backendId(0) {}
+
+            ~ThreadQueueHandle() {
+                if (queue != nullptr)
+                    queue->isOwned.store(false, std::memory_order_release);
+            }
+
+            unsigned long long backendId;
+            std::shared_ptr<ThreadQueue> queue;
+        };
+
+        void wakeWriter() {
+            wakeCondition.notify_one();
+        }
+
+        /// @brief Pushes the given log into the queue of the current thread, with the `AsyncQueueMode::PER_THREAD` mode
+        void pushToThreadQueue(const LogRecord& record) {
+            ThreadQueue& threadQueue = getThreadQueue();
+            AsyncRecord* queuedRecord;
+            while ((queuedRecord = threadQueue.tryReservePush()) == nullptr) {
+                if (stopRequested.load(std::memory_order_acquire) || overflowPolicy != AsyncOverflowPolicy::BLOCK) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                wakeWriter();
+                std::this_thread::yield();
+            }
+
+            queuedRecord->assign(record);
+            threadQueue.commitPush();
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (isWriterSleeping.load(std::memory_order_relaxed))
+                wakeWriter();
+        }
+
+        /// @brief Returns the queue of the current thread, reusing the queue of an exited thread or creating one the first time
+        ThreadQueue& getThreadQueue() {
+            ThreadQueueHandle& handle = threadQueueHandle;
+            if (handle.backendId == id)
+                return *handle.queue;
+
+            if (handle.queue != nullptr)
+                handle.queue->isOwned.store(false, std::memory_order_release);
+            handle.backendId = id;
+            handle.queue = nullptr;
+
+            std::lock_guard<std::mutex> lock(threadQueuesMutex);
+            for (const std::shared_ptr<ThreadQueue>& threadQueue : ownedThreadQueues) {
+                bool isOwned = false;
+                if (threadQueue->isOwned.compare_exchange_strong(isOwned, true, std::memory_order_acq_rel)) {
+                    handle.queue = threadQueue;
+                    return *handle.queue;
+                }
+            }
+            handle.queue = std::make_shared<ThreadQueue>(threadQueueDepth);
+            handle.queue->next = threadQueues.load(std::memory_order_relaxed);
+            threadQueues.store(handle.queue.get(), std::memory_order_release);
+            ownedThreadQueues.push_back(handle.queue);
+            return *handle.queue;
+        }
+
+        /**
+         * @brief Writes the pending logs of the queues of the threads, oldest first
+         * @note Each queue is in order ; the oldest log is the oldest of their first logs.
+         * @returns Whether any log was written.
+         */
+        bool writeThreadQueues(std::vector<std::string_view>& extraViews, std::vector<Field>& fieldViews) {
+            bool hasWritten = false;
+            while (true) {
+                ThreadQueue* oldestQueue = nullptr;
+                const AsyncRecord* oldestRecord = nullptr;
+                for (ThreadQueue* threadQueue = threadQueues.load(std::memory_order_acquire); threadQueue != nullptr; threadQueue = threadQueue->next) {
+                    const AsyncRecord* record = threadQueue->tryPeek();
+                    if (record != nullptr && (oldestRecord == nullptr || record->timestamp < oldestRecord->timestamp)) {
+                        oldestQueue = threadQueue;
+                        oldestRecord = record;
+                    }
+                }
+                if (oldestQueue == nullptr)
+                    return hasWritten;
+                writeToOutputs(oldestRecord->view(extraViews, fieldViews));
+                oldestQueue->commitPop();
+                hasWritten = true;
+            }
+        }
+
+        /// @brief Returns whether every log pushed so far has been written
+        bool isDrained() const {
+            if (queueMode == AsyncQueueMode::SHARED)
+                return processedCount.load(std::memory_order_acquire) >= queue.getPushedCount();
+            for (ThreadQueue* threadQueue = threadQueues.load(std::memory_order_acquire); threadQueue != nullptr; threadQueue = threadQueue->next) {
+                if (threadQueue->getPoppedCount() < threadQueue->getPushedCount())
+                    return false;
+            }
+            return true;
+        }
+
+        void run() {
+            writerThreadId.store(std::this_thread::get_id(), std::memory_order_release);
+            std::vector<std::string_view> extraViews;
+            std::vector<Field> fieldViews;
+            while (true) {
+                size_t queueDepth = getQueueDepth();
+                if (queueDepth > queueHighWaterMark.load(std::memory_order_relaxed))
+                    queueHighWaterMark.store(queueDepth, std::memory_order_relaxed);
+
+                bool hasWritten = false;
+                if (queueMode == AsyncQueueMode::PER_THREAD) {
+                    hasWritten = writeThreadQueues(extraViews, fieldViews);
+                } else {
+                    size_t position;
+                    AsyncQueue::Cell* cell;
+                    while ((cell = queue.tryReservePop(position)) != nullptr) {
+                        writeToOutputs(cell->record.view(extraViews, fieldViews));
+                        queue.commitPop(cell, position);
+                        processedCount.fetch_add(1, std::memory_order_release);
+                        hasWritten = true;
+                    }
+                }
+                if (hasWritten)
+                    continue;
+
+                // The queue is empty : serves pending flush requests, then exits or waits for more logs
+                unsigned long long requests = flushRequests.load(std::memory_order_acquire);
+                if (requests != flushesDone.load(std::memory_order_relaxed)) {
+                    flushOutputs();
+                    flushesDone.store(requests, std::memory_order_release);
+                }
+                if (stopRequested.load(std::memory_order_acquire) && isDrained()) {
+                    flushOutputs();
+                    isWriterStopped.store(true, std::memory_order_release);
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                isWriterSleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (isDrained() && !stopRequested.load(std::memory_order_acquire)
+                    && flushRequests.load(std::memory_order_acquire) == flushesDone.load(std::memory_order_relaxed)) {
+                    wakeCondition.wait_for(lock, std::chrono::milliseconds(TINYLOG_ASYNC_IDLE_WAIT_MS));
+                }
+                isWriterSleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        /// @brief The queue of the current thread, with the `AsyncQueueMode::PER_THREAD` mode
+        inline static thread_local ThreadQueueHandle threadQueueHandle{};
+        /// @brief How many backends were created, giving each one its ID
+        inline static std::atomic<unsigned long long> createdBackendsCount{0};
+
+        const unsigned long long id = createdBackendsCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        AsyncQueue queue;
+        AsyncOverflowPolicy overflowPolicy;
+        AsyncQueueMode queueMode;
+        size_t threadQueueDepth;
+        /// @brief The queues of the threads, most recently created first, with the `AsyncQueueMode::PER_THREAD` mode
+        std::atomic<ThreadQueue*> threadQueues{nullptr};
+        /// @brief Keeps the queues of the threads alive, and serializes their creation
+        std::vector<std::shared_ptr<ThreadQueue>> ownedThreadQueues;
+        std::mutex threadQueuesMutex;
+        alignas(64) std::atomic<size_t> processedCount{0};
+        /// @brief Only written by the writer thread
+        std::atomic<size_t> queueHighWaterMark{0};
+        alignas(64) std::atomic<unsigned long long> droppedCount{0};
+        std::atomic<unsigned long long> flushRequests{0};
+        std::atomic<unsigned long long> flushesDone{0};
+        std::atomic<bool> stopRequested{false};
+        /// @brief Set by the writer thread once it wrote its last logs, right before exiting
+        std::atomic<bool> isWriterStopped{false};
+        std::atomic<bool> isWriterSleeping{false};
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        /// @brief Set by the writer thread when it starts : other threads compare against it, as `stop()` may be
+        ///     joining `writerThread` meanwhile
+        std::atomic<std::thread::id> writerThreadId{};
+        std::thread writerThread;
+    };
+
+    /**
+     * @brief Logs the summary of the logs suppressed at the given call site, if there is one to log
+     * @param isForced Whether to log it even if the last summary is recent
+     */
+    static void logSuppressedSummary(CallSite& callSite, bool isForced) {
+        std::uint64_t suppressedCount = callSite.takeSuppressedCount(isForced);
+        if (suppressedCount == 0)
+            return;
+
+        FormatBuffer& message = summaryBuffer;
+        message.clear();
+        message.append("Suppressed ");
+        message.appendUnsignedInteger(suppressedCount);
+        message.append(" messages from ");
+        message.append(callSite.filePath);
+        message.append(':');
+        message.appendInteger(callSite.lineNumber);
+
+        LogRecord record{callSite.logLevel, LogClock::now(), true, callSite.filePath, callSite.lineNumber, message.view(), nullptr, 0, &callSite};
+        submit(record);
+    }
+
+    /// @brief Returns the counters of the current thread, created on its first log
+    static ThreadMetrics& getThreadMetrics() {
+        if (ThreadMetrics* metrics = threadMetrics)
+            return *metrics;
+        static thread_local ThreadMetricsOwner owner;
+        threadMetrics = &owner.metrics;
+        return owner.metrics;
+    }
+
+    /// @brief Counts a log discarded because of its level
+    static void countFilteredLog(LogLevel logLevel) {
+        if (static_cast<unsigned char>(logLevel) < LogMetrics::logLevelsCount)
+            ThreadMetrics::add(getThreadMetrics().filteredCounts[static_cast<size_t>(logLevel)], 1);
+    }
+
+    /// @brief Returns the nanoseconds elapsed since the given time
+    static long long getElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Hands the given log to the asynchronous queue in asynchronous mode, or writes it to the outputs otherwise
+     */
+    static void submit(const LogRecord& record) {
+        // The context is only attached to the logs that passed the log level, as a pointer to the arena
+        if (record.contextFields == nullptr && LogContext::getFieldsCount() > 0) {
+            LogRecord contextRecord = record;
+            contextRecord.contextFields = LogContext::getFields();
+            contextRecord.contextFieldsCount = LogContext::getFieldsCount();
+            submit(contextRecord);
+            return;
+        }
+        if (static_cast<unsigned char>(record.logLevel) < LogMetrics::logLevelsCount)
+            ThreadMetrics::add(getThreadMetrics().emittedCounts[static_cast<size_t>(record.logLevel)], 1);
+        ReadGuard guard;
+        if (AsyncBackend* backend = asyncBackend.load(std::memory_order_acquire))
+            backend->push(record);
+        else
+            writeToOutputs(record);
+        // The process may well die right after a FATAL log : it must not stay in a queue or a buffer
+        if (TINYLOG_FLUSH_ON_FATAL == 1 && record.logLevel == FATAL)
+            flush();
+    }
+
+    /**
+     * @brief Drains the asynchronous queue and writes the buffered data of every sink, see `emergencyFlush()`
+     * @param crashRecord A log to write to the string and JSON outputs after the pending ones, if not `nullptr`
+     */
+    static void emergencyFlush(const LogRecord* crashRecord) {
+        if (isEmergencyFlushed.exchange(true, std::memory_order_acq_rel))
+            return;
+        // Reads as a `ReadGuard` would, through a reader epoch of its own : the one of the thread may not exist yet
+        emergencyReaderEpoch.epoch.store(currentEpoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TINYLOG_EMERGENCY_FLUSH_TIMEOUT_MS);
+        if (AsyncBackend* backend = asyncBackend.load(std::memory_order_acquire))
+            backend->drainUntil(deadline);
+
+        FormatBuffer& buffer = emergencyBuffer;
+        for (const std::atomic<const OutputList*>* outputs : {&stringOutputs, &jsonOutputs, &binaryOutputs}) {
+            const OutputList* outputList = outputs->load(std::memory_order_acquire);
+            if (outputList == nullptr)
+                continue;
+            bool isFormatted = false;
+            const PatternLayout* formattedLayout = nullptr;
+            for (const std::shared_ptr<Output>& output : *outputList) {
+                // A single attempt : the output may be written by the interrupted thread, its sink half-updated. Once
+                // taken, the output is kept, so that no other thread writes to it anymore.
+                if (output->isWriting.exchange(true, std::memory_order_acquire) || output->isClosed)
+                    continue;
+
+                // The predicate of the filter may allocate : only its log level is checked
+                if (crashRecord != nullptr && outputs != &binaryOutputs
+                    && static_cast<char>(crashRecord->logLevel) >= static_cast<char>(output->filter.minLogLevel)) {
+                    if (outputs == &stringOutputs) {
+                        if (!isFormatted || output->layout.get() != formattedLayout) {
+                            buffer.clear();
+                            if (output->layout != nullptr)
+                                formatString(buffer, *crashRecord, *output->layout);
+                            else
+                                formatString(buffer, *crashRecord);
+                            formattedLayout = output->layout.get();
+                            isFormatted = true;
+                            if (buffer.isFull())
+                                buffer.data()[buffer.size() - 1] = '\n';
+                        }
+                        output->sink->emergencyWrite(buffer.view());
+                    } else {
+                        buffer.clear();
+                        buffer.append(',');
+                        formatJson(buffer, *crashRecord);
+                        buffer.append('\n');
+                        if (buffer.isFull())
+                            buffer.data()[buffer.size() - 1] = '\n';
+                        if (output->jsonFormat == JsonFormat::NDJSON)
+                            output->sink->emergencyWrite(buffer.view().substr(1));
+                        else
+                            output->sink->emergencyWrite(buffer.view().substr(output->writtenCount.load(std::memory_order_relaxed) == 0 ? 1 : 0, buffer.size() - 1));
+                        output->writtenCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                output->sink->emergencyWrite(output->suffix);
+            }
+        }
+        emergencyReaderEpoch.epoch.store(0, std::memory_order_release);
+    }
+
+#if TINYLOG_HAS_POSIX == 1
+    /// @brief Returns the name of the given signal, as written in the log of the crash
+    static std::string_view getSignalName(int signalNumber) {
+        switch (signalNumber) {
+            case SIGSEGV: return "SIGSEGV";
+            case SIGABRT: return "SIGABRT";
+            case SIGBUS:  return "SIGBUS";
+            case SIGFPE:  return "SIGFPE";
+            case SIGILL:  return "SIGILL";
+            case SIGTERM: return "SIGTERM";
+            case SIGINT:  return "SIGINT";
+            default:      return "";
+        }
+    }
+
+    /**
+     * @brief Logs the crash and writes everything pending, then raises the signal again with its previous handler
+     * @note Only calls async-signal-safe functions ; waiting for the writer thread is best effort, see `emergencyFlush()`.
+     */
+    static void onCrashSignal(int signalNumber) {
+        int savedErrno = errno;
+        char message[64] = "Received signal ";
+        size_t messageSize = sizeof "Received signal " - 1;
+        std::string_view signalName = getSignalName(signalNumber);
+        if (signalName.empty()) {
+            messageSize = std::to_chars(message + messageSize, message + sizeof message, signalNumber).ptr - message;
+        } else {
+            std::memcpy(message + messageSize, signalName.data(), signalName.size());
+            messageSize += signalName.size();
+        }
+        LogRecord record{FATAL, LogClock::now(), true, "", -1, std::string_view(message, messageSize), nullptr, 0};
+        emergencyFlush(&record);
+
+        for (size_t i = 0; i < crashSignalsCount; i++) {
+            if (crashSignals[i].signalNumber == signalNumber)
+                ::sigaction(signalNumber, &crashSignals[i].previousAction, nullptr);
+        }
+        errno = savedErrno;
+        // Delivered once the handler returns, as the signal is blocked while it runs
+        ::raise(signalNumber);
+    }
+#endif
+
+    /**
+     * @brief Formats the given log once per output format, and writes it to every enabled output.
+     */
+    static void writeToOutputs(const LogRecord& record) {
+        ReadGuard guard;
+        FormatBuffer& buffer = formatBuffer;
+
+        // One log out of TINYLOG_METRICS_TIMING_PERIOD is timed, as reading the clock costs more than counting
+        ThreadMetrics& metrics = getThreadMetrics();
+        bool isTimed = false;
+        if (TINYLOG_METRICS_TIMING_PERIOD > 0 && metrics.timingCountdown-- == 0) {
+            metrics.timingCountdown = TINYLOG_METRICS_TIMING_PERIOD - 1;
+            isTimed = true;
+        }
+        long long formattingNanoseconds = 0;
+        long long writingNanoseconds = 0;
+        std::chrono::steady_clock::time_point start{};
+
+        // String output ; only formatted once an output accepts the log
+        const OutputList* stringOutputList = stringOutputs.load(std::memory_order_acquire);
+        if (stringOutputList != nullptr) {
+            bool isFormatted = false;
+            const PatternLayout* formattedLayout = nullptr;
+            for (const std::shared_ptr<Output>& output : *stringOutputList) {
+                if (!output->filter.accepts(record))
+                    continue;
+                if (!isFormatted || output->layout.get() != formattedLayout) {
+                    if (isTimed)
+                        start = std::chrono::steady_clock::now();
+                    buffer.clear();
+                    if (output->layout != nullptr)
+                        formatString(buffer, record, *output->layout);
+                    else
+                        formatString(buffer, record);
+                    formattedLayout = output->layout.get();
+                    isFormatted = true;
+                    if (isTimed)
+                        formattingNanoseconds += getElapsedNanoseconds(start);
+                }
+                if (isTimed)
+                    start = std::chrono::steady_clock::now();
+                output->write(buffer.view(), record);
+                if (isTimed)
+                    writingNanoseconds += getElapsedNanoseconds(start);
+            }
+        }
+
+        // JSON output, formatted as ",{...}\n" : array outputs skip the newline, and the separator for their first log ;
+        // NDJSON outputs skip the separator
+        const OutputList* jsonOutputList = jsonOutputs.load(std::memory_order_acquire);
+        if (jsonOutputList != nullptr) {
+            bool isFormatted = false;
+            for (const std::shared_ptr<Output>& output : *jsonOutputList) {
+                if (!output->filter.accepts(record))
+                    continue;
+                if (!isFormatted) {
+                    if (isTimed)
+                        start = std::chrono::steady_clock::now();
+                    buffer.clear();
+                    buffer.append(',');
+                    formatJson(buffer, record);
+                    buffer.append('\n');
+                    isFormatted = true;
+                    if (isTimed)
+                        formattingNanoseconds += getElapsedNanoseconds(start);
+                }
+                if (isTimed)
+                    start = std::chrono::steady_clock::now();
+                if (output->jsonFormat == JsonFormat::NDJSON)
+                    output->write(buffer.view().substr(1), record);
+                else
+                    output->write(buffer.view().substr(0, buffer.size() - 1), record, 1);
+                if (isTimed)
+                    writingNanoseconds += getElapsedNanoseconds(start);
+            }
+        }
+
+        // Binary output ; each binary sink encodes the log itself, as it depends on what it has already written
+        const OutputList* binaryOutputList = binaryOutputs.load(std::memory_order_acquire);
+        if (binaryOutputList != nullptr) {
+            for (const std::shared_ptr<Output>& output : *binaryOutputList) {
+                if (!output->filter.accepts(record))
+                    continue;
+                if (isTimed)
+                    start = std::chrono::steady_clock::now();
+                output->write(std::string_view(), record);
+                if (isTimed)
+                    writingNanoseconds += getElapsedNanoseconds(start);
+            }
+        }
+
+        if (isTimed) {
+            ThreadMetrics::add(metrics.formattingNanoseconds, formattingNanoseconds * TINYLOG_METRICS_TIMING_PERIOD);
+            ThreadMetrics::add(metrics.writingNanoseconds, writingNanoseconds * TINYLOG_METRICS_TIMING_PERIOD);
+        }
+    }
+
+    /**
+     * @brief Flushes every string and JSON output
+     */
+    static void flushOutputs() {
+        ReadGuard guard;
+        flushesCount.fetch_add(1, std::memory_order_relaxed);
+        for (const std::atomic<const OutputList*>* outputs : {&stringOutputs, &jsonOutputs, &binaryOutputs}) {
+            const OutputList* outputList = outputs->load(std::memory_order_acquire);
+            if (outputList == nullptr)
+                continue;
+            for (const std::shared_ptr<Output>& output : *outputList) {
+                std::lock_guard<std::mutex> lock(output->writeMutex);
+                if (output->isClosed || !output->startWriting())
+                    continue;
+                output->sink->flush();
+                output->stopWriting();
+            }
+        }
+    }
+
+    /**
+     * @brief Publishes the given output list in place of the current one, retiring the current one until the threads
+     *      that may still be reading it are done with it.
+     * @warning `configurationMutex` must be held.
+     */
+    static void publishOutputs(std::atomic<const OutputList*>& outputs, std::unique_ptr<const OutputList> outputList) {
+        const OutputList* previousOutputList = outputs.exchange(outputList.release(), std::memory_order_acq_rel);
+        if (previousOutputList != nullptr)
+            retire({0, std::unique_ptr<const OutputList>(previousOutputList), nullptr});
+        updateOutputsMinLogLevel();
+    }
+
+    /**
+     * @brief Recomputes the lowest log level wanted by an output, from the current output lists
+     * @warning `configurationMutex` must be held.
+     */
+    static void updateOutputsMinLogLevel() {
+        char minLogLevel = noOutputLogLevel;
+        for (const std::atomic<const OutputList*>* outputs : {&stringOutputs, &jsonOutputs, &binaryOutputs}) {
+            const OutputList* outputList = outputs->load(std::memory_order_acquire);
+            if (outputList == nullptr)
+                continue;
+            for (const std::shared_ptr<Output>& output : *outputList) {
+                minLogLevel = std::min(minLogLevel, static_cast<char>(output->filter.minLogLevel));
+            }
+        }
+        outputsMinLogLevel.store(minLogLevel, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns whether a log of the given level is at least the current log level, and is wanted by an output
+     */
+    bool isLoggedLogLevel(LogLevel givenLogLevel) const {
+        return static_cast<char>(givenLogLevel) >= static_cast<char>(getLogLevel()) && isWantedByOutputs(givenLogLevel);
+    }
+
+    /// @brief Returns whether at least one output wants logs of the given level
+    static bool isWantedByOutputs(LogLevel givenLogLevel) {
+        return static_cast<char>(givenLogLevel) >= outputsMinLogLevel.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the effective log level of the logger chain of the current thread, `TINYLOG_DEFAULT_LOG_LEVEL` if it is empty
+    static LogLevel getThreadLogLevel() {
+        LogLevel logLevel = threadLogLevel;
+        return (logLevel == INHERIT) ? TINYLOG_DEFAULT_LOG_LEVEL : logLevel;
+    }
+
+    /**
+     * @brief Logs the given message from the given call site, once its log level has been checked
+     * @param fields, fieldsCount The typed fields of the log, if any
+     */
+    static void logFromCallSite(CallSite& callSite, std::string_view message, std::initializer_list<std::string_view> extras,
+                                const Field* fields = nullptr, size_t fieldsCount = 0) {
+        callSite.registerOnce();
+        if (callSite.isLimited())
+            logSuppressedSummary(callSite, false);
+
+        LogRecord record{callSite.logLevel, LogClock::now(), true, callSite.filePath, callSite.lineNumber, message, extras.begin(), extras.size(),
+                         &callSite, fields, fieldsCount};
+        submit(record);
+    }
+
+    /// @brief Logs the given message along with typed fields from the given call site, once its log level has been checked
+    static void logFromCallSite(CallSite& callSite, std::string_view message, const Field* fields, size_t fieldsCount) {
+        logFromCallSite(callSite, message, {}, fields, fieldsCount);
+    }
+
+    /**
+     * @brief Adds the given output to the JSON outputs, opening its array if it is an `ARRAY` output
+     * @warning `configurationMutex` must be held.
+     */
+    static void addJsonOutput(std::shared_ptr<Output> output, JsonFormat jsonFormat, const OutputFilter& filter) {
+        output->jsonFormat = jsonFormat;
+        if (jsonFormat == JsonFormat::ARRAY)
+            addOutput(jsonOutputs, std::move(output), filter, "[", "]");
+        else
+            addOutput(jsonOutputs, std::move(output), filter);
+    }
+
+    /**
+     * @brief Adds the given output to the string outputs, with the given layout
+     * @note Outputs with the same pattern share their layout, so that the log is only formatted once for all of them.
+     * @warning `configurationMutex` must be held.
+     */
+    static void addStringOutput(std::shared_ptr<Output> output, const OutputFilter& filter, const PatternLayout& layout) {
+        assert(layout.isValid() && "Unknown specifier in the pattern");
+        if (!layout.isDefault()) {
+            if (const OutputList* outputList = stringOutputs.load(std::memory_order_acquire)) {
+                for (const std::shared_ptr<Output>& otherOutput : *outputList) {
+                    if (otherOutput->layout != nullptr && otherOutput->layout->getPattern() == layout.getPattern())
+                        output->layout = otherOutput->layout;
+                }
+            }
+            if (output->layout == nullptr)
+                output->layout = std::make_shared<const PatternLayout>(layout);
+        }
+        addOutput(stringOutputs, std::move(output), filter);
+    }
+
+    /**
+     * @brief Writes the given prefix to the output, then publishes a copy of the current output list with the output appended.
+     * @param filter Which logs are written to the output
+     * @param suffix Written to the output when it is closed
+     * @warning `configurationMutex` must be held.
+     */
+    static void addOutput(std::atomic<const OutputList*>& outputs, std::shared_ptr<Output> output, const OutputFilter& filter,
+                          std::string_view prefix = "", std::string_view suffix = "") {
+        output->filter = filter;
+        output->suffix = suffix;
+        if (!prefix.empty())
+            output->sink->write(prefix, nullptr);
+        const OutputList* currentOutputList = outputs.load(std::memory_order_acquire);
+        auto outputList = std::make_unique<OutputList>(currentOutputList ? *currentOutputList : OutputList{});
+        outputList->push_back(std::move(output));
+        publishOutputs(outputs, std::move(outputList));
+    }
+
+    /**
+     * @brief Writes their suffix to every output of the current output list, marks them as closed and publishes
+     *      an empty output list.
+     * @warning `configurationMutex` must be held.
+     */
+    static void closeOutputs(std::atomic<const OutputList*>& outputs) {
+        const OutputList* currentOutputList = outputs.load(std::memory_order_acquire);
+        if (currentOutputList == nullptr)
+            return;
+        for (const std::shared_ptr<Output>& output : *currentOutputList) {
+            std::lock_guard<std::mutex> lock(output->writeMutex);
+            if (output->isClosed || !output->startWriting())
+                continue;
+            if (!output->suffix.empty())
+                output->sink->write(output->suffix, nullptr);
+            output->sink->flush();
+            output->isClosed = true;
+            output->stopWriting();
+        }
+        publishOutputs(outputs, nullptr);
+    }
+
+    /**
+     * @brief Marks the current thread as reading, see `ReadGuard`
+     * @note Stores the current epoch as the one the thread started reading at, then fences, so that either a thread
+     *      retiring a resource sees that this thread is reading, or this thread sees the resource that replaced it.
+     */
+    static void startReading() {
+        if (threadReadDepth++ > 0)
+            return;
+        ReaderEpoch* readerEpoch = threadReaderEpoch;
+        if (readerEpoch == nullptr) {
+            static thread_local ReaderEpochOwner owner;
+            threadReaderEpoch = readerEpoch = &owner.readerEpoch;
+        }
+        if (readerEpoch == &exitedReaderEpoch)
+            unregisteredReadersCount.fetch_add(1, std::memory_order_relaxed);
+        else
+            readerEpoch->epoch.store(currentEpoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Marks the current thread as done reading, see `ReadGuard`, then frees the resources no thread reads anymore
+     */
+    static void stopReading() {
+        if (--threadReadDepth > 0)
+            return;
+        ReaderEpoch* readerEpoch = threadReaderEpoch;
+        if (readerEpoch == &exitedReaderEpoch)
+            unregisteredReadersCount.fetch_sub(1, std::memory_order_release);
+        else
+            readerEpoch->epoch.store(0, std::memory_order_release);
+
+        // Never waits for the configuration to change : the next thread to stop reading will try again
+        if (retiredResourcesCount.load(std::memory_order_relaxed) != 0 && configurationMutex.try_lock()) {
+            reclaimRetiredResources();
+            configurationMutex.unlock();
+        }
+    }
+
+    /**
+     * @brief Retires the given resource, replaced or stopped, and frees the ones no thread reads anymore
+     * @warning `configurationMutex` must be held.
+     */
+    static void retire(RetiredResource resource) {
+        resource.epoch = currentEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+        retiredResources.push_back(std::move(resource));
+        reclaimRetiredResources();
+    }
+
+    /**
+     * @brief Frees the retired resources that no thread reads anymore : the ones retired at or before the epoch every
+     *      reading thread started at.
+     * @warning `configurationMutex` must be held.
+     */
+    static void reclaimRetiredResources() {
+        if (retiredResources.empty())
+            return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (unregisteredReadersCount.load(std::memory_order_acquire) == 0) {
+            std::uint64_t oldestReaderEpoch = std::numeric_limits<std::uint64_t>::max();
+            if (std::uint64_t epoch = emergencyReaderEpoch.epoch.load(std::memory_order_acquire))
+                oldestReaderEpoch = epoch;
+            {
+                std::lock_guard<std::mutex> lock(readersMutex);
+                for (const ReaderEpoch* readerEpoch : liveReaderEpochs) {
+                    std::uint64_t epoch = readerEpoch->epoch.load(std::memory_order_acquire);
+                    if (epoch != 0)
+                        oldestReaderEpoch = std::min(oldestReaderEpoch, epoch);
+                }
+            }
+            retiredResources.erase(std::remove_if(retiredResources.begin(), retiredResources.end(), [oldestReaderEpoch](const RetiredResource& resource) {
+                return resource.epoch <= oldestReaderEpoch;
+            }), retiredResources.end());
+        }
+        retiredResourcesCount.store(retiredResources.size(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes the given time as `1970-01-01T00:00:00`, in UTC
+     * @note Computes the date itself (Howard Hinnant's `civil_from_days`) : `gmtime_r()` may lock, and is not
+     *      async-signal-safe.
+     */
+    static void formatDateTime(long long secondsSinceEpoch, char (&dateTime)[sizeof "1970-01-01T00:00:00"]) {
+        long long days = secondsSinceEpoch / 86400;
+        long long secondOfDay = secondsSinceEpoch % 86400;
+        if (secondOfDay < 0) {
+            secondOfDay += 86400;
+            days--;
+        }
+        days += 719468;
+        long long era = (days >= 0 ? days : days - 146096) / 146097;
+        long long dayOfEra = days - era * 146097;
+        long long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        long long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        long long shiftedMonth = (5 * dayOfYear + 2) / 153;
+        long long day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+        long long month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+        long long year = yearOfEra + era * 400 + (month <= 2);
+
+        auto writeDigits = [](char* destination, long long value, int digitsCount) {
+            for (int i = digitsCount - 1; i >= 0; i--) {
+                destination[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        };
+        std::memcpy(dateTime, "0000-00-00T00:00:00", sizeof dateTime);
+        writeDigits(dateTime, year, 4);
+        writeDigits(dateTime + 5, month, 2);
+        writeDigits(dateTime + 8, day, 2);
+        writeDigits(dateTime + 11, secondOfDay / 3600, 2);
+        writeDigits(dateTime + 14, secondOfDay / 60 % 60, 2);
+        writeDigits(dateTime + 17, secondOfDay % 60, 2);
+    }
+
+    /// @brief Returns whether the given character must be escaped in a JSON string
+    static bool isJsonEscaped(char character) {
+        return character == '"' || character == '\\' || static_cast<unsigned char>(character) < 0x20;
+    }
+
+    /// @brief Returns the index of the lowest set bit of the given mask, which must not be 0
+    static unsigned int getFirstSetBit(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned int>(index);
+#else
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+    }
+
+    /**
+     * @brief Returns the first character from `begin` that must be escaped in a JSON string, `end` if there are none
+     * @note Scans 32 (AVX2) or 16 (SSE2, NEON) characters at a time when available.
+     */
+    static const char* findJsonEscaped(const char* begin, const char* end) {
+#if TINYLOG_HAS_AVX2 == 1
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i lastControl = _mm256_set1_epi8(0x1F);
+        for (; end - begin >= 32; begin += 32) {
+            __m256i characters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(characters, lastControl), characters);
+            __m256i isEscaped = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(characters, quote), _mm256_cmpeq_epi8(characters, backslash)), isControl);
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(isEscaped));
+            if (mask != 0)
+                return begin + getFirstSetBit(mask);
+        }
+#endif
+#if TINYLOG_HAS_SSE2 == 1
+        const __m128i quote16 = _mm_set1_epi8('"');
+        const __m128i backslash16 = _mm_set1_epi8('\\');
+        const __m128i lastControl16 = _mm_set1_epi8(0x1F);
+        for (; end - begin >= 16; begin += 16) {
+            __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(characters, lastControl16), characters);
+            __m128i isEscaped = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(characters, quote16), _mm_cmpeq_epi8(characters, backslash16)), isControl);
+            int mask = _mm_movemask_epi8(isEscaped);
+            if (mask != 0)
+                return begin + getFirstSetBit(static_cast<unsigned int>(mask));
+        }
+#elif TINYLOG_HAS_NEON == 1
+        const uint8x16_t quote16 = vdupq_n_u8('"');
+        const uint8x16_t backslash16 = vdupq_n_u8('\\');
+        const uint8x16_t firstPrintable16 = vdupq_n_u8(0x20);
+        for (; end - begin >= 16; begin += 16) {
+            uint8x16_t characters = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+            uint8x16_t isEscaped = vorrq_u8(vorrq_u8(vceqq_u8(characters, quote16), vceqq_u8(characters, backslash16)), vcltq_u8(characters, firstPrintable16));
+            if (vmaxvq_u8(isEscaped) != 0)
+                break;  // The scalar loop below finds it within the next 16 characters
+        }
+#endif
+        for (; begin != end; begin++) {
+            if (isJsonEscaped(*begin))
+                return begin;
+        }
+        return end;
+    }
+
+public:
+    /**
+     * @brief Calculates the ISO 8601 timestamp of the given time, and appends it to the buffer.
+     * @param buffer The buffer to append the timestamp to.
+     * @param timestamp The time to convert.
+     * @note The date and time are only formatted once per second and per thread ; the fractional part, if any, is
+     *      formatted every time.
+     * @note Async-signal-safe into `emergencyBuffer`, so that the crash handler can timestamp its log : the thread-local
+     *      cache is then left alone, as it may be allocated on first use.
+     */
+    static void appendIso8601Timestamp(FormatBuffer& buffer, LogClock::time_point timestamp) {
+        auto second = std::chrono::floor<std::chrono::seconds>(timestamp);
+        long long secondsSinceEpoch = second.time_since_epoch().count();
+
+        if (&buffer == &emergencyBuffer) {
+            char dateTime[sizeof "1970-01-01T00:00:00"];
+            formatDateTime(secondsSinceEpoch, dateTime);
+            buffer.append(std::string_view(dateTime, sizeof dateTime - 1));
+        } else {
+            TimestampCache& cache = timestampCache;
+            if (cache.second != secondsSinceEpoch) {
+                formatDateTime(secondsSinceEpoch, cache.dateTime);
+                cache.second = secondsSinceEpoch;
+            }
+            buffer.append(std::string_view(cache.dateTime, sizeof cache.dateTime - 1));
+        }
+
+        TimestampPrecision precision = timestampPrecision.load(std::memory_order_relaxed);
+        if (precision != TimestampPrecision::SECONDS) {
+            long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timestamp - second).count();
+            // Formats 1xxxxxx or 1xxx, then turns the leading 1 into the point, so that the fraction keeps its zeros
+            if (precision == TimestampPrecision::MILLISECONDS)
+                microseconds = microseconds / 1000 + 1000;
+            else
+                microseconds += 1000000;
+            size_t start = buffer.size();
+            buffer.appendInteger(microseconds);
+            if (buffer.size() > start)
+                buffer.data()[start] = '.';
+        }
+        buffer.append('Z');
+    }
+
+    /**
+     * @brief Appends the given string to the buffer, escaped as a JSON string (RFC 8259)
+     * @param buffer The buffer to append the string to.
+     * @param stringToEscape A string with possibly double quotes, backslashes or control characters inside, to be escaped.
+     * @note Runs of characters that don't need to be escaped are found with `findJsonEscaped()`, and copied at once.
+     *      Other bytes, including invalid UTF-8, are copied as they are.
+     */
+    static void appendEscapedString(FormatBuffer& buffer, std::string_view stringToEscape) {
+        static constexpr char hexDigits[] = "0123456789abcdef";
+        const char* runStart = stringToEscape.data();
+        const char* end = runStart + stringToEscape.size();
+        while (runStart != end) {
+            const char* escaped = findJsonEscaped(runStart, end);
+            buffer.append(std::string_view(runStart, static_cast<size_t>(escaped - runStart)));
+            if (escaped == end)
+                break;
+            buffer.append('\\');
+            switch (*escaped) {
+                case '"':  buffer.append('"'); break;
+                case '\\': buffer.append('\\'); break;
+                case '\b': buffer.append('b'); break;
+                case '\f': buffer.append('f'); break;
+                case '\n': buffer.append('n'); break;
+                case '\r': buffer.append('r'); break;
+                case '\t': buffer.append('t'); break;
+                default:
+                    buffer.append("u00");
+                    buffer.append(hexDigits[(*escaped >> 4) & 0xF]);
+                    buffer.append(hexDigits[*escaped & 0xF]);
+            }
+            runStart = escaped + 1;
+        }
+    }
+
+    /**
+     * @brief Appends the value of the given field to the buffer
+     * @param isJson Whether to write it as a JSON value : strings are then quoted and escaped, durations are written as
+     *      a number of nanoseconds, and non-finite numbers as `null`. Otherwise, durations get their unit, e.g. `15ms`.
+     */
+    static void appendFieldValue(FormatBuffer& buffer, const Field& field, bool isJson) {
+        switch (field.type) {
+            case FieldType::INTEGER:
+                buffer.appendInteger(field.integer);
+                break;
+            case FieldType::UNSIGNED_INTEGER:
+                buffer.appendUnsignedInteger(field.unsignedInteger);
+                break;
+            case FieldType::FLOATING_POINT:
+                if (isJson && (field.floatingPoint != field.floatingPoint || field.floatingPoint - field.floatingPoint != 0))
+                    buffer.append("null");
+                else
+                    buffer.appendFloatingPoint(field.floatingPoint);
+                break;
+            case FieldType::BOOLEAN:
+                buffer.append(field.boolean ? "true" : "false");
+                break;
+            case FieldType::STRING:
+                if (isJson) {
+                    buffer.append('"');
+                    appendEscapedString(buffer, field.string);
+                    buffer.append('"');
+                } else {
+                    buffer.append(field.string);
+                }
+                break;
+            case FieldType::DURATION:
+                if (isJson) {
+                    buffer.appendInteger(field.nanoseconds);
+                } else if (field.nanoseconds % 1000000000 == 0) {
+                    buffer.appendInteger(field.nanoseconds / 1000000000);
+                    buffer.append('s');
+                } else if (field.nanoseconds % 1000000 == 0) {
+                    buffer.appendInteger(field.nanoseconds / 1000000);
+                    buffer.append("ms");
+                } else if (field.nanoseconds % 1000 == 0) {
+                    buffer.appendInteger(field.nanoseconds / 1000);
+                    buffer.append("us");
+                } else {
+                    buffer.appendInteger(field.nanoseconds);
+                    buffer.append("ns");
+                }
+                break;
+        }
+    }
+
+    /**
+     * @brief Formats the given log as a string, the way string outputs receive it
+     */
+    static void formatString(FormatBuffer& buffer, const LogRecord& record) {
+        std::string_view logLevelName = getLogLevelName(record.logLevel, true);
+        buffer.append('[');
+        buffer.append(logLevelName);
+        buffer.append("] ");
+        if (record.showTimestamp) {
+            appendIso8601Timestamp(buffer, record.timestamp);
+            buffer.append(" - ");
+        }
+        if (!record.filePath.empty()) {
+            buffer.append(record.filePath);
+            buffer.append(' ');
+        }
+        if (record.lineNumber != -1) {
+            buffer.append("(line ");
+            buffer.appendInteger(record.lineNumber);
+            buffer.append(") ");
+        }
+        if (!record.filePath.empty() || record.lineNumber != -1) {
+            buffer.append("- ");
+        }
+        buffer.append(record.message);
+        size_t itemsCount = record.extrasCount + record.fieldsCount + record.contextFieldsCount;
+        if (itemsCount > 0) {
+            buffer.append(" - EXTRAS ");
+            buffer.append((TINYLOG_EXTRAS_ON_SEPARATE_LINES) ? ":" : "- ");
+        }
+        // Fields, then the fields of the context, are listed along with the extras, as "<KEY> = <VALUE>"
+        for (size_t i = 0; i < itemsCount; i++) {
+            if (TINYLOG_EXTRAS_ON_SEPARATE_LINES) {
+                buffer.append('\n');
+                buffer.appendRepeated(' ', logLevelName.size() + 3);
+                buffer.append("- ");
+            } else {
+                buffer.append(' ');
+            }
+            if (i < record.extrasCount) {
+                buffer.append(record.extras[i]);
+            } else {
+                size_t fieldIndex = i - record.extrasCount;
+                const Field& field = (fieldIndex < record.fieldsCount) ? record.fields[fieldIndex] : record.contextFields[fieldIndex - record.fieldsCount];
+                buffer.append(field.key);
+                buffer.append(" = ");
+                appendFieldValue(buffer, field, false);
+            }
+            buffer.append(" ;");
+        }
+        buffer.append('\n');
+    }
+
+    /**
+     * @brief Formats the given log as a string, with the given layout
+     */
+    static void formatString(FormatBuffer& buffer, const LogRecord& record, const PatternLayout& layout) {
+        if (layout.isDefault()) {
+            formatString(buffer, record);
+            return;
+        }
+        for (const PatternLayout::Segment& segment : layout.segments) {
+            size_t start = buffer.size();
+            switch (segment.token) {
+                case PatternLayout::Token::LITERAL:
+                    buffer.append(std::string_view(layout.literals).substr(segment.literalOffset, segment.literalSize));
+                    break;
+                case PatternLayout::Token::TIMESTAMP:
+                    if (record.showTimestamp)
+                        appendIso8601Timestamp(buffer, record.timestamp);
+                    break;
+                case PatternLayout::Token::LOG_LEVEL:
+                    buffer.append(getLogLevelName(record.logLevel));
+                    break;
+                case PatternLayout::Token::FILE_PATH:
+                    buffer.append(record.filePath);
+                    break;
+                case PatternLayout::Token::LINE_NUMBER:
+                    if (record.lineNumber != -1)
+                        buffer.appendInteger(record.lineNumber);
+                    break;
+                case PatternLayout::Token::MESSAGE:
+                    buffer.append(record.message);
+                    break;
+                case PatternLayout::Token::CONTEXT:
+                    for (size_t i = 0; i < record.contextFieldsCount; i++) {
+                        if (i > 0)
+                            buffer.append(' ');
+                        buffer.append(record.contextFields[i].key);
+                        buffer.append(" = ");
+                        appendFieldValue(buffer, record.contextFields[i], false);
+                        buffer.append(" ;");
+                    }
+                    break;
+                case PatternLayout::Token::EXTRAS:
+                case PatternLayout::Token::EXTRAS_ON_SEPARATE_LINES:
+                    for (size_t i = 0; i < record.extrasCount + record.fieldsCount; i++) {
+                        // Indented as the built-in layout does, under its padded log level
+                        if (segment.token == PatternLayout::Token::EXTRAS_ON_SEPARATE_LINES && TINYLOG_EXTRAS_ON_SEPARATE_LINES) {
+                            buffer.append('\n');
+                            buffer.appendRepeated(' ', getLogLevelName(record.logLevel, true).size() + 3);
+                            buffer.append("- ");
+                        } else if (i > 0) {
+                            buffer.append(' ');
+                        }
+                        if (i < record.extrasCount) {
+                            buffer.append(record.extras[i]);
+                        } else {
+                            const Field& field = record.fields[i - record.extrasCount];
+                            buffer.append(field.key);
+                            buffer.append(" = ");
+                            appendFieldValue(buffer, field, false);
+                        }
+                        buffer.append(" ;");
+                    }
+                    break;
+            }
+            size_t valueSize = buffer.size() - start;
+            if (valueSize < segment.width) {
+                if (segment.isLeftAligned)
+                    buffer.appendRepeated(' ', segment.width - valueSize);
+                else
+                    buffer.insertRepeated(start, ' ', segment.width - valueSize);
+            }
+        }
+    }
+
+    /**
+     * @brief Formats the given log as JSON, the way JSON outputs receive it (without the separator between logs)
+     */
+    static void formatJson(FormatBuffer& buffer, const LogRecord& record) {
+        buffer.append("{\"severity\":\"");
+        buffer.append(getLogLevelName(record.logLevel));
+        buffer.append("\",\"message\":\"");
+        appendEscapedString(buffer, record.message);
+        buffer.append("\",\"timestamp\":\"");
+        appendIso8601Timestamp(buffer, record.timestamp);
+        buffer.append('"');
+        if (record.extrasCount > 0) {
+            buffer.append(",\"extras\":[");
+            for (size_t i = 0; i < record.extrasCount; i++) {
+                buffer.append('"');
+                appendEscapedString(buffer, record.extras[i]);
+                buffer.append('"');
+                if (i < record.extrasCount - 1) {
+                    buffer.append(',');
+                }
+            }
+            buffer.append(']');
+        }
+        appendJsonFields(buffer, ",\"fields\":{", record.fields, record.fieldsCount);
+        appendJsonFields(buffer, ",\"context\":{", record.contextFields, record.contextFieldsCount);
+        buffer.append('}');
+    }
+
+    /**
+     * @brief Appends the given fields as a JSON object, after the given prefix, if there is at least one
+     */
+    static void appendJsonFields(FormatBuffer& buffer, std::string_view prefix, const Field* fields, size_t fieldsCount) {
+        if (fieldsCount == 0)
+            return;
+        buffer.append(prefix);
+        for (size_t i = 0; i < fieldsCount; i++) {
+            buffer.append('"');
+            appendEscapedString(buffer, fields[i].key);
+            buffer.append("\":");
+            appendFieldValue(buffer, fields[i], true);
+            if (i < fieldsCount - 1) {
+                buffer.append(',');
+            }
+        }
+        buffer.append('}');
+    }
+};
+
+/**
+ * @brief A logger identified by a name, such as `net.http`, whose log level can be changed at runtime.
+ * @note Named loggers form a hierarchy following the dots of their names : `net.http` is a child of `net`, itself a
+ *      child of the root named logger. A named logger set to `INHERIT` uses the log level of its parent ; if every
+ *      named logger up to the root is set to `INHERIT`, it uses the log level of the logger chain of the calling thread.
+ * @note Named loggers are created once and never destroyed : `get()` looks them up under a lock, so keep the returned
+ *      reference. Their effective log level is then a single atomic load, and changing it never blocks `log()`.
+ * @note They log to the outputs of the `Logger`s, with the same macros : `TinyLog_logc(netLogger, TinyLog::DEBUG, "...")`.
+ */
+class NamedLogger {
+public:
+    NamedLogger(const NamedLogger&) = delete;
+    NamedLogger& operator=(const NamedLogger&) = delete;
+
+    /**
+     * @brief Returns the named logger of the given name, creating it and its parents if they don't exist yet
+     * @param name The name of the logger, its parents' names being separated by dots. Empty for the root.
+     * @returns The named logger, valid until the end of the program.
+     */
+    static NamedLogger& get(std::string_view name) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return getLocked(registry, name);
+    }
+
+    /// @brief Returns the root named logger, the ancestor of every named logger
+    static NamedLogger& getRoot() {
+        return get("");
+    }
+
+    /// @brief Returns the name of this logger
+    std::string_view getName() const {
+        return name;
+    }
+
+    /// @brief Returns the log level this logger is set to, possibly `INHERIT`
+    LogLevel getConfiguredLogLevel() const {
+        return configuredLogLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the log level of this logger, resolved against its parents
+     * @returns A log level, other than `INHERIT`.
+     */
+    LogLevel getLogLevel() const {
+        LogLevel logLevel = effectiveLogLevel.load(std::memory_order_relaxed);
+        return (logLevel == INHERIT) ? Logger::getThreadLogLevel() : logLevel;
+    }
+
+    /**
+     * @brief Sets the log level of this logger, and of its children set to `INHERIT`
+     * @param logLevel The new log level, or `INHERIT` to use the one of the parent
+     */
+    void setLogLevel(LogLevel logLevel) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        setLogLevelLocked(logLevel);
+    }
+
+    /**
+     * @brief Sets the log level of the named logger of the given name, see the non-static `setLogLevel()`
+     * @param loggerName The name of the logger, created if it doesn't exist yet
+     */
+    static void setLogLevel(std::string_view loggerName, LogLevel logLevel) {
+        get(loggerName).setLogLevel(logLevel);
+    }
+
+    /**
+     * @brief Returns whether a log of the given level would be logged, see `Logger::isEnabledLogLevel()`
+     */
+    bool isEnabledLogLevel(LogLevel givenLogLevel) const {
+        if (isCompiledLogLevel(givenLogLevel) && isLoggedLogLevel(givenLogLevel))
+            return true;
+        Logger::countFilteredLog(givenLogLevel);
+        return false;
+    }
+
+    /**
+     * @brief Logs the given message if the given log level is at least the log level of this logger
+     * @see `Logger::log()`
+     */
+    void log(LogLevel givenLogLevel, std::string_view message, std::initializer_list<std::string_view> extras = {}, std::string_view filePath = "", int lineNumber = -1, bool showTimestamp = true) {
+        if (!isLoggedLogLevel(givenLogLevel)) {
+            Logger::countFilteredLog(givenLogLevel);
+            return;
+        }
+
+        LogRecord record{givenLogLevel, LogClock::now(), showTimestamp, filePath, lineNumber, message, extras.begin(), extras.size()};
+        Logger::submit(record);
+    }
+
+    /**
+     * @brief Logs the given message from the given call site, see `Logger::log()`.
+     * @note Used by the logging macros.
+     */
+    void log(CallSite& callSite, std::string_view message, std::initializer_list<std::string_view> extras = {}) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        Logger::logFromCallSite(callSite, message, extras);
+    }
+
+    /**
+     * @brief Logs the given message along with typed fields from the given call site, see `Logger::log()`.
+     * @note Used by the `TinyLog_logf` macro.
+     */
+    template <typename... Fields, std::enable_if_t<(std::is_same_v<Fields, Field> && ...), int> = 0>
+    void log(CallSite& callSite, std::string_view message, const Field& firstField, const Fields&... otherFields) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        const Field fields[] = {firstField, otherFields...};
+        Logger::logFromCallSite(callSite, message, fields, sizeof...(otherFields) + 1);
+    }
+
+    /**
+     * @brief Calls the given function with every named logger, parents first
+     * @param function Any callable taking a `NamedLogger&`. Must not create named loggers nor change their log levels.
+     */
+    template <typename Function>
+    static void forEach(Function&& function) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        forEachLocked(getLocked(registry, ""), function);
+    }
+
+    /**
+     * @brief Sets the log levels of named loggers from a specification, such as `"*=WARN, net=DEBUG, net.http=INFO"`
+     * @param specification `name=LEVEL` entries, separated by commas, semicolons or new lines. `*` names the root
+     *      logger, and `#` starts a comment, up to the end of the line.
+     * @param isReplacing If true, the named loggers that aren't in the specification are set to `INHERIT`
+     * @returns Whether the specification is valid. If it isn't, no log level is changed.
+     */
+    static bool configure(std::string_view specification, bool isReplacing = false) {
+        std::vector<std::pair<std::string_view, LogLevel>> entries;
+        if (!parseSpecification(specification, entries))
+            return false;
+
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (isReplacing) {
+            for (const auto& [loggerName, namedLogger] : registry.loggers) {
+                namedLogger->configuredLogLevel.store(INHERIT, std::memory_order_relaxed);
+            }
+        }
+        for (const auto& [loggerName, logLevel] : entries) {
+            getLocked(registry, loggerName).configuredLogLevel.store(logLevel, std::memory_order_relaxed);
+        }
+        NamedLogger& root = getLocked(registry, "");
+        root.propagate(root.configuredLogLevel.load(std::memory_order_relaxed));
+        return true;
+    }
+
+    /**
+     * @brief Sets the log levels of named loggers from the specification held by the given environment variable, see `configure()`
+     * @returns Whether the variable is set and holds a valid specification.
+     */
+    static bool configureFromEnvironment(const char* variableName = "TINYLOG_LEVELS") {
+        const char* specification = std::getenv(variableName);
+        return specification != nullptr && configure(specification);
+    }
+
+    /**
+     * @brief Sets the log levels of named loggers from the specification held by the given file, see `configure()`
+     * @note The file is the whole configuration : the named loggers it doesn't list are set to `INHERIT`.
+     * @returns Whether the file could be read and holds a valid specification.
+     */
+    static bool configureFromFile(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return false;
+        std::string specification;
+        char chunk[4096];
+        size_t readSize;
+        while ((readSize = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            specification.append(chunk, readSize);
+        }
+        bool isRead = std::ferror(file) == 0;
+        std::fclose(file);
+        return isRead && configure(specification, true);
+    }
+
+#if TINYLOG_HAS_POSIX == 1
+    /**
+     * @brief Reloads the given configuration file with `configureFromFile()` each time the process receives the given signal
+     * @param path The configuration file
+     * @param signalNumber The signal triggering a reload, `SIGHUP` by default
+     * @note The signal handler only writes to a pipe ; the file is read by a dedicated thread, never in the handler.
+     * @returns Whether the reload is set up. Fails if it already is.
+     */
+    static bool enableReloadOnSignal(const std::string& path, int signalNumber = SIGHUP) {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        std::thread& reloadThread = getReloadThreadOwner().thread;
+        if (reloadThread.joinable())
+            return false;
+        int pipeDescriptors[2];
+        if (::pipe(pipeDescriptors) != 0)
+            return false;
+        for (int descriptor : pipeDescriptors) {
+            ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+        }
+        // The handler must never block, even if the reload thread lags behind
+        ::fcntl(pipeDescriptors[1], F_SETFL, ::fcntl(pipeDescriptors[1], F_GETFL) | O_NONBLOCK);
+
+        reloadWriteDescriptor.store(pipeDescriptors[1], std::memory_order_release);
+        struct sigaction action {};
+        action.sa_handler = &onReloadSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        if (::sigaction(signalNumber, &action, &previousReloadAction) != 0) {
+            reloadWriteDescriptor.store(-1, std::memory_order_release);
+            ::close(pipeDescriptors[0]);
+            ::close(pipeDescriptors[1]);
+            return false;
+        }
+        reloadSignalNumber = signalNumber;
+        reloadThread = std::thread([path, readDescriptor = pipeDescriptors[0]]() {
+            char signalByte;
+            while (true) {
+                ssize_t readSize = ::read(readDescriptor, &signalByte, 1);
+                if (readSize < 0 && errno == EINTR)
+                    continue;
+                if (readSize <= 0)
+                    break;
+                configureFromFile(path);
+            }
+            ::close(readDescriptor);
+        });
+        return true;
+    }
+
+    /**
+     * @brief Stops reloading the configuration file on signal, and restores the previous handler of the signal
+     * @note Done at exit for a reload still enabled.
+     */
+    static void disableReloadOnSignal() {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        stopReload(getReloadThreadOwner().thread);
+    }
+#endif
+
+private:
+    NamedLogger(std::string loggerName, NamedLogger* parentLogger) : name(std::move(loggerName)), parent(parentLogger) {
+        if (parent != nullptr)
+            effectiveLogLevel.store(parent->effectiveLogLevel.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The named loggers, by name
+     * @note A function-local static, so that named loggers can be created during static initialization.
+     */
+    struct Registry {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<NamedLogger>> loggers;
+    };
+
+    static Registry& getRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Returns the named logger of the given name, creating it and its parents if needed
+     * @warning The mutex of the registry must be held.
+     */
+    static NamedLogger& getLocked(Registry& registry, std::string_view loggerName) {
+        auto position = registry.loggers.find(std::string(loggerName));
+        if (position != registry.loggers.end())
+            return *position->second;
+
+        NamedLogger* parentLogger = nullptr;
+        if (!loggerName.empty()) {
+            size_t lastDot = loggerName.rfind('.');
+            parentLogger = &getLocked(registry, (lastDot == std::string_view::npos) ? std::string_view() : loggerName.substr(0, lastDot));
+        }
+        std::unique_ptr<NamedLogger> namedLogger(new NamedLogger(std::string(loggerName), parentLogger));
+        NamedLogger& createdLogger = *namedLogger;
+        registry.loggers.emplace(std::string(loggerName), std::move(namedLogger));
+        if (parentLogger != nullptr)
+            parentLogger->children.push_back(&createdLogger);
+        return createdLogger;
+    }
+
+    template <typename Function>
+    static void forEachLocked(NamedLogger& namedLogger, Function& function) {
+        function(namedLogger);
+        for (NamedLogger* child : namedLogger.children) {
+            forEachLocked(*child, function);
+        }
+    }
+
+    /**
+     * @brief Sets the log level of this logger, and propagates it to its children
+     * @warning The mutex of the registry must be held.
+     */
+    void setLogLevelLocked(LogLevel logLevel) {
+        configuredLogLevel.store(logLevel, std::memory_order_relaxed);
+        propagate((logLevel != INHERIT || parent == nullptr) ? logLevel : parent->effectiveLogLevel.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Sets the effective log level of this logger, and resolves the ones of its children against it
+     * @warning The mutex of the registry must be held.
+     */
+    void propagate(LogLevel logLevel) {
+        effectiveLogLevel.store(logLevel, std::memory_order_relaxed);
+        for (NamedLogger* child : children) {
+            LogLevel childLogLevel = child->configuredLogLevel.load(std::memory_order_relaxed);
+            child->propagate((childLogLevel == INHERIT) ? logLevel : childLogLevel);
+        }
+    }
+
+    bool isLoggedLogLevel(LogLevel givenLogLevel) const {
+        return static_cast<char>(givenLogLevel) >= static_cast<char>(getLogLevel()) && Logger::isWantedByOutputs(givenLogLevel);
+    }
+
+    /**
+     * @brief Splits the given specification into its entries, see `configure()`
+     * @returns Whether every entry is valid.
+     */
+    static bool parseSpecification(std::string_view specification, std::vector<std::pair<std::string_view, LogLevel>>& entries) {
+        auto trim = [](std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r'))
+                text.remove_prefix(1);
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+                text.remove_suffix(1);
+            return text;
+        };
+        while (!specification.empty()) {
+            size_t lineEnd = std::min(specification.find('\n'), specification.size());
+            std::string_view line = specification.substr(0, lineEnd);
+            specification.remove_prefix(std::min(lineEnd + 1, specification.size()));
+            line = line.substr(0, line.find('#'));
+
+            while (!line.empty()) {
+                size_t entryEnd = std::min(line.find_first_of(",;"), line.size());
+                std::string_view entry = trim(line.substr(0, entryEnd));
+                line.remove_prefix(std::min(entryEnd + 1, line.size()));
+                if (entry.empty())
+                    continue;
+
+                size_t equalSign = entry.find('=');
+                if (equalSign == std::string_view::npos)
+                    return false;
+                std::string_view loggerName = trim(entry.substr(0, equalSign));
+                LogLevel logLevel;
+                if (loggerName.empty() || !parseLogLevel(trim(entry.substr(equalSign + 1)), logLevel))
+                    return false;
+                entries.emplace_back((loggerName == "*") ? std::string_view() : loggerName, logLevel);
+            }
+        }
+        return true;
+    }
+
+#if TINYLOG_HAS_POSIX == 1
+    /// @brief Wakes the reload thread up ; only calls async-signal-safe functions
+    static void onReloadSignal(int) {
+        int savedErrno = errno;
+        // Counted before the descriptor is read, so that it isn't closed while written to
+        runningReloadHandlersCount.fetch_add(1);
+        int descriptor = reloadWriteDescriptor.load();
+        if (descriptor != -1) {
+            char signalByte = 'r';
+            ssize_t writtenSize = ::write(descriptor, &signalByte, 1);
+            (void)writtenSize;
+        }
+        runningReloadHandlersCount.fetch_sub(1);
+        errno = savedErrno;
+    }
+
+    /**
+     * @brief Restores the previous handler of the signal, and ends the given reload thread if it runs
+     * @warning The reload mutex must be held.
+     */
+    static void stopReload(std::thread& reloadThread) {
+        if (!reloadThread.joinable())
+            return;
+        ::sigaction(reloadSignalNumber, &previousReloadAction, nullptr);
+        int descriptor = reloadWriteDescriptor.exchange(-1);
+        // A handler started before the sigaction() may still write to the descriptor it read
+        while (runningReloadHandlersCount.load() != 0) {
+            std::this_thread::yield();
+        }
+        // Closing the write end ends the reload thread, once the pending reloads are done
+        ::close(descriptor);
+        reloadThread.join();
+    }
+
+    /// @brief Owns the reload thread, so that a reload still enabled at exit is stopped instead of terminating the program
+    struct ReloadThreadOwner {
+        std::thread thread;
+
+        ~ReloadThreadOwner() {
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            stopReload(thread);
+        }
+    };
+
+    static ReloadThreadOwner& getReloadThreadOwner() {
+        // The registry is created first so that it is destroyed last, once the reload thread is joined
+        getRegistry();
+        static ReloadThreadOwner reloadThreadOwner;
+        return reloadThreadOwner;
+    }
+
+    /// @brief Serializes `enableReloadOnSignal()` and `disableReloadOnSignal()`
+    inline static std::mutex reloadMutex;
+    /// @brief The write end of the pipe waking the reload thread up, -1 if the reload is disabled
+    inline static std::atomic<int> reloadWriteDescriptor{-1};
+    /// @brief The signal handlers between their read of `reloadWriteDescriptor` and their write to it
+    inline static std::atomic<int> runningReloadHandlersCount{0};
+    inline static int reloadSignalNumber = 0;
+    inline static struct sigaction previousReloadAction {};
+#endif
+
+    const std::string name;
+    NamedLogger* const parent;
+    std::vector<NamedLogger*> children;
+    std::atomic<LogLevel> configuredLogLevel{INHERIT};
+    /// @brief The log level resolved against the parents, `INHERIT` if every logger up to the root is set to `INHERIT`
+    std::atomic<LogLevel> effectiveLogLevel{INHERIT};
+};
+
+/**
+ * @brief A lightweight scope overriding the log level of the current thread until it is destroyed, as a `Logger` would.
+ * @note It only pushes an entry onto the logger chain of the thread, a fixed-size thread-local array : unlike a `Logger`,
+ *      it neither allocates nor touches any shared counter, so it fits hot functions. It logs to the outputs the same
+ *      way, whether a `Logger` is alive or not.
+ * @note The loggers of the thread use its log level while it is alive. It can be logged through too, to be named
+ *      `logger` for the logging macros.
+ * @warning Must be destroyed by the thread that created it, in reverse order of creation.
+ */
+class ScopedLogLevel {
+public:
+    /**
+     * @brief Overrides the log level of the current thread
+     * @param logLevel The log level of this scope, or `INHERIT` to use the one of its parent.
+     */
+    explicit ScopedLogLevel(LogLevel logLevel = INHERIT) {
+        Logger::pushChainEntry(this, nullptr, logLevel);
+    }
+
+    ~ScopedLogLevel() {
+        Logger::popChainEntry(this);
+    }
+
+    ScopedLogLevel(const ScopedLogLevel&) = delete;
+    ScopedLogLevel& operator=(const ScopedLogLevel&) = delete;
+
+    /// @brief Returns the log level of the current thread, the one of this scope unless it was overridden since
+    LogLevel getLogLevel() const {
+        return Logger::getThreadLogLevel();
+    }
+
+    /**
+     * @brief Returns whether a log of the given level would be logged, see `Logger::isEnabledLogLevel()`
+     */
+    bool isEnabledLogLevel(LogLevel givenLogLevel) const {
+        if (isCompiledLogLevel(givenLogLevel) && isLoggedLogLevel(givenLogLevel))
+            return true;
+        Logger::countFilteredLog(givenLogLevel);
+        return false;
+    }
+
+    /**
+     * @brief Logs the given message if the given log level is at least the log level of this scope
+     * @see `Logger::log()`
+     */
+    void log(LogLevel givenLogLevel, std::string_view message, std::initializer_list<std::string_view> extras = {}, std::string_view filePath = "", int lineNumber = -1, bool showTimestamp = true) {
+        if (!isLoggedLogLevel(givenLogLevel)) {
+            Logger::countFilteredLog(givenLogLevel);
+            return;
+        }
+
+        LogRecord record{givenLogLevel, LogClock::now(), showTimestamp, filePath, lineNumber, message, extras.begin(), extras.size()};
+        Logger::submit(record);
+    }
+
+    /**
+     * @brief Logs the given message from the given call site, see `Logger::log()`.
+     * @note Used by the logging macros.
+     */
+    void log(CallSite& callSite, std::string_view message, std::initializer_list<std::string_view> extras = {}) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        Logger::logFromCallSite(callSite, message, extras);
+    }
+
+    /**
+     * @brief Logs the given message along with typed fields from the given call site, see `Logger::log()`.
+     * @note Used by the `TinyLog_logf` macro.
+     */
+    template <typename... Fields, std::enable_if_t<(std::is_same_v<Fields, Field> && ...), int> = 0>
+    void log(CallSite& callSite, std::string_view message, const Field& firstField, const Fields&... otherFields) {
+        if (!isLoggedLogLevel(callSite.logLevel)) {
+            Logger::countFilteredLog(callSite.logLevel);
+            return;
+        }
+        const Field fields[] = {firstField, otherFields...};
+        Logger::logFromCallSite(callSite, message, fields, sizeof...(otherFields) + 1);
+    }
+
+private:
+    bool isLoggedLogLevel(LogLevel givenLogLevel) const {
+        return static_cast<char>(givenLogLevel) >= static_cast<char>(getLogLevel()) && Logger::isWantedByOutputs(givenLogLevel);
+    }
+};
+
+/**
+ * @brief Calls the given callback with the metrics of TinyLog at a regular interval, from a dedicated thread
+ * @note E.g. to push them to a metrics system, or to log them ; see `Logger::getMetrics()` and `LogMetrics::toPrometheus()`.
+ */
+class MetricsReporter {
+public:
+    /**
+     * @brief Starts reporting the metrics
+     * @param callback Called with each snapshot of the metrics, from the reporting thread.
+     * @param interval The time between two reports.
+     */
+    explicit MetricsReporter(std::function<void(const LogMetrics&)> callback, std::chrono::milliseconds interval = std::chrono::seconds(10)) :
+        callback(std::move(callback)), interval(interval), reporterThread([this]() { run(); }) {}
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    /// @brief Stops reporting, after a last report
+    ~MetricsReporter() {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            isStopping = true;
+        }
+        stopCondition.notify_one();
+        reporterThread.join();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!isStopping) {
+            stopCondition.wait_for(lock, interval, [this]() { return isStopping; });
+            lock.unlock();
+            callback(Logger::getMetrics());
+            lock.lock();
+        }
+    }
+
+    std::function<void(const LogMetrics&)> callback;
+    std::chrono::milliseconds interval;
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool isStopping = false;
+    std::thread reporterThread;
+};
+
+#if TINYLOG_HAS_POSIX == 1
+/**
+ * @brief The transport of a `NetworkSink`
+ */
+enum class NetworkProtocol: char {
+    /// @brief A stream, reconnected whenever it breaks
+    TCP = 0,
+    /// @brief A datagram per log, sent in batches. Logs are lost silently if the collector is unreachable.
+    UDP
+};
+
+/**
+ * @brief How a `NetworkSink` frames its logs
+ */
+enum class NetworkFraming: char {
+    /// @brief RFC 5424 syslog messages, octet-counted over TCP (RFC 6587) ; their message is the log as its output formatted it
+    SYSLOG = 0,
+    /// @brief OTLP/HTTP logs export requests, encoded in JSON, a batch per request. TCP only.
+    OTLP
+};
+
+/**
+ * @brief The settings of a `NetworkSink`
+ */
+struct NetworkSinkOptions {
+    NetworkProtocol protocol = NetworkProtocol::TCP;
+    NetworkFraming framing = NetworkFraming::SYSLOG;
+    /// @brief The APP-NAME of the syslog messages, or the `service.name` of the OTLP resource
+    std::string appName = "tinylog";
+    /// @brief The syslog facility, user-level messages by default
+    int syslogFacility = 1;
+    /// @brief The path OTLP requests are sent to
+    std::string otlpPath = "/v1/logs";
+    /// @brief Size, in bytes, from which the pending logs are sent as a batch
+    size_t maxBatchSize = TINYLOG_BATCH_DEFAULT_SIZE;
+    /// @brief Maximal time a log waits for its batch to be sent
+    std::chrono::milliseconds maxLatency{100};
+    /// @brief Logs of this level or above are sent right away, along with the rest of the batch
+    LogLevel flushLogLevel = ERROR;
+    /// @brief Maximal size, in bytes, of the logs waiting to be sent : new logs are dropped beyond it
+    size_t maxSpillSize = TINYLOG_NETWORK_SPILL_DEFAULT_SIZE;
+    /// @brief Delay before the first reconnection, doubled after each failure up to `maxReconnectDelay`
+    std::chrono::milliseconds minReconnectDelay{100};
+    std::chrono::milliseconds maxReconnectDelay{30000};
+    /// @brief How long the destructor waits for the pending logs to be sent
+    std::chrono::milliseconds closeTimeout{1000};
+};
+
+/**
+ * @brief A sink sending the logs to a collector over the network, as syslog messages or OTLP requests.
+ * @note `write()` only appends the framed log to a bounded spill buffer : a dedicated thread sends the batches through
+ *      a non-blocking socket, and reconnects with an exponential backoff. A slow or unreachable collector thus never
+ *      blocks the logging threads ; once the spill buffer is full, new logs are dropped and counted.
+ * @note Framing text (e.g. the brackets around JSON logs) is ignored. With `NetworkFraming::SYSLOG`, the message of each
+ *      syslog message is the log as its output formatted it : add the sink to a JSON output to ship JSON. With
+ *      `NetworkFraming::OTLP`, the log itself is rendered as an OTLP log record, whatever the output.
+ * @note OTLP responses are read and discarded : a batch is only sent again if the connection breaks before it is sent.
+ */
+class NetworkSink : public Sink {
+public:
+    /**
+     * @brief Starts sending to the given collector
+     * @param host The host name or address of the collector, resolved on each connection.
+     * @param port The port of the collector.
+     * @param options The settings of the sink.
+     */
+    NetworkSink(std::string host, unsigned short port, NetworkSinkOptions options = {}) :
+        host(std::move(host)), port(port), options(std::move(options)) {
+        assert((this->options.protocol == NetworkProtocol::TCP || this->options.framing == NetworkFraming::SYSLOG) && "OTLP requires TCP");
+        if (this->options.framing == NetworkFraming::OTLP)
+            this->options.protocol = NetworkProtocol::TCP;
+        reconnectDelay = this->options.minReconnectDelay;
+
+        char hostName[256] = {};
+        if (::gethostname(hostName, sizeof(hostName) - 1) != 0 || hostName[0] == '\0')
+            std::strcpy(hostName, "-");
+        // The syslog header after the priority and the timestamp, and the OTLP request around the log records
+        syslogHeader = std::string(" ") + hostName + ' ' + (this->options.appName.empty() ? "-" : this->options.appName) + ' ' +
+            std::to_string(::getpid()) + " - - ";
+        FormatBuffer prefix;
+        prefix.append("{\"resourceLogs\":[{\"resource\":{\"attributes\":[{\"key\":\"service.name\",\"value\":{\"stringValue\":\"");
+        Logger::appendEscapedString(prefix, this->options.appName);
+        prefix.append("\"}},{\"key\":\"host.name\",\"value\":{\"stringValue\":\"");
+        Logger::appendEscapedString(prefix, hostName);
+        prefix.append("\"}}]},\"scopeLogs\":[{\"scope\":{\"name\":\"tinylog\",\"version\":\"" TINYLOG_VERSION "\"},\"logRecords\":[");
+        otlpPrefix = std::string(prefix.view());
+
+        pending.reserve(this->options.maxBatchSize);
+        if (::pipe(wakePipe) == 0) {
+            for (int descriptor : wakePipe) {
+                ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+                ::fcntl(descriptor, F_SETFL, ::fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+            }
+        } else {
+            wakePipe[0] = wakePipe[1] = -1;
+        }
+        senderThread = std::thread([this]() { run(); });
+    }
+
+    NetworkSink(const NetworkSink&) = delete;
+    NetworkSink& operator=(const NetworkSink&) = delete;
+
+    /// @brief Sends the pending logs, waiting at most `closeTimeout` for them to be sent
+    ~NetworkSink() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isStopping = true;
+        }
+        wake();
+        senderThread.join();
+        for (int descriptor : wakePipe) {
+            if (descriptor >= 0)
+                ::close(descriptor);
+        }
+    }
+
+    void write(std::string_view data, const LogRecord* record) override {
+        if (record == nullptr)
+            return;
+        frame.clear();
+        if (options.framing == NetworkFraming::OTLP)
+            appendOtlpLogRecord(*record);
+        else
+            appendSyslogMessage(data, *record);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        bool wasEmpty = pending.size() == 0;
+        if (pending.size() + inFlightSize + frame.size() + 1 > options.maxSpillSize) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (options.framing == NetworkFraming::OTLP && !wasEmpty)
+            pending.append(',');
+        pending.append(frame.view());
+        pendingLogsCount++;
+        if (wasEmpty)
+            oldestLogTime = std::chrono::steady_clock::now();
+
+        bool isFlushing = static_cast<char>(record->logLevel) >= static_cast<char>(options.flushLogLevel);
+        if (isFlushing)
+            isFlushRequested = true;
+        if (wasEmpty || isFlushing || pending.size() >= options.maxBatchSize) {
+            lock.unlock();
+            wake();
+        }
+    }
+
+    /// @brief Asks for the pending logs to be sent right away, without waiting for them to be sent
+    void flush() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isFlushRequested = true;
+        }
+        wake();
+    }
+
+    /**
+     * @brief Sends the pending logs right away, and waits for them to be handed to the system
+     * @returns Whether every log was sent before the timeout.
+     */
+    bool waitUntilSent(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        isFlushRequested = true;
+        lock.unlock();
+        wake();
+        lock.lock();
+        return sentCondition.wait_for(lock, timeout, [this]() { return pending.size() == 0 && inFlightSize == 0; });
+    }
+
+    /// @brief Returns whether the sink is currently connected to the collector
+    bool isConnected() const {
+        return isSocketConnected.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns how many logs were dropped, because the spill buffer was full or the sink was destroyed first
+    long long getDroppedCount() const {
+        return droppedCount.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns how many bytes were handed to the system
+    long long getSentBytesCount() const {
+        return sentBytesCount.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Returns how many connections were established
+    long long getConnectionsCount() const {
+        return connectionsCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief Maps the log levels to the syslog severities, from debug (7) to critical (2)
+    static int getSyslogSeverity(LogLevel logLevel) {
+        switch (logLevel) {
+            case DEBUG: return 7;
+            case INFO:  return 6;
+            case WARN:  return 4;
+            case ERROR: return 3;
+            default:    return 2;
+        }
+    }
+
+    /// @brief Maps the log levels to the OTLP severity numbers
+    static int getOtlpSeverityNumber(LogLevel logLevel) {
+        switch (logLevel) {
+            case DEBUG: return 5;
+            case INFO:  return 9;
+            case WARN:  return 13;
+            case ERROR: return 17;
+            default:    return 21;
+        }
+    }
+
+    /// @brief Frames the given formatted log as an octet-counted RFC 5424 syslog message : `<LENGTH> <PRI>1 <TIMESTAMP> ...`
+    void appendSyslogMessage(std::string_view data, const LogRecord& record) {
+        while (!data.empty() && (data.back() == '\n' || data.back() == '\r')) {
+            data.remove_suffix(1);
+        }
+        message.clear();
+        message.append('<');
+        message.appendInteger(options.syslogFacility * 8 + getSyslogSeverity(record.logLevel));
+        message.append(">1 ");
+        Logger::appendIso8601Timestamp(message, record.timestamp);
+        message.append(syslogHeader);
+        message.append(data);
+        frame.appendUnsignedInteger(message.size());
+        frame.append(' ');
+        frame.append(message.view());
+    }
+
+    /// @brief Renders the given log as an OTLP log record, in JSON
+    void appendOtlpLogRecord(const LogRecord& record) {
+        frame.append("{\"timeUnixNano\":\"");
+        frame.appendInteger(std::chrono::duration_cast<std::chrono::nanoseconds>(record.timestamp.time_since_epoch()).count());
+        frame.append("\",\"severityNumber\":");
+        frame.appendInteger(getOtlpSeverityNumber(record.logLevel));
+        frame.append(",\"severityText\":\"");
+        frame.append(getLogLevelName(record.logLevel));
+        frame.append("\",\"body\":{\"stringValue\":\"");
+        Logger::appendEscapedString(frame, record.message);
+        frame.append("\"},\"attributes\":[");
+        bool isFirst = true;
+        auto appendKey = [&](std::string_view key) {
+            frame.append(isFirst ? "{\"key\":\"" : ",{\"key\":\"");
+            Logger::appendEscapedString(frame, key);
+            frame.append("\",\"value\":{");
+            isFirst = false;
+        };
+        if (!record.filePath.empty()) {
+            appendKey("code.filepath");
+            frame.append("\"stringValue\":\"");
+            Logger::appendEscapedString(frame, record.filePath);
+            frame.append("\"}}");
+        }
+        if (record.lineNumber != -1) {
+            appendKey("code.lineno");
+            frame.append("\"intValue\":\"");
+            frame.appendInteger(record.lineNumber);
+            frame.append("\"}}");
+        }
+        if (record.extrasCount > 0) {
+            appendKey("tinylog.extras");
+            frame.append("\"arrayValue\":{\"values\":[");
+            for (size_t i = 0; i < record.extrasCount; i++) {
+                frame.append(i == 0 ? "{\"stringValue\":\"" : ",{\"stringValue\":\"");
+                Logger::appendEscapedString(frame, record.extras[i]);
+                frame.append("\"}");
+            }
+            frame.append("]}}}");
+        }
+        for (size_t i = 0; i < record.fieldsCount + record.contextFieldsCount; i++) {
+            const Field& field = (i < record.fieldsCount) ? record.fields[i] : record.contextFields[i - record.fieldsCount];
+            appendKey(field.key);
+            switch (field.type) {
+                case FieldType::INTEGER:
+                case FieldType::UNSIGNED_INTEGER:
+                case FieldType::DURATION:
+                    // 64-bits integers are quoted in the JSON encoding of OTLP
+                    frame.append("\"intValue\":\"");
+                    Logger::appendFieldValue(frame, field, true);
+                    frame.append('"');
+                    break;
+                case FieldType::FLOATING_POINT:
+                    frame.append("\"doubleValue\":");
+                    Logger::appendFieldValue(frame, field, true);
+                    break;
+                case FieldType::BOOLEAN:
+                    frame.append("\"boolValue\":");
+                    Logger::appendFieldValue(frame, field, true);
+                    break;
+                case FieldType::STRING:
+                    frame.append("\"stringValue\":");
+                    Logger::appendFieldValue(frame, field, true);
+                    break;
+            }
+            frame.append("}}");
+        }
+        frame.append("]}");
+    }
+
+    /// @brief Wakes the sender thread up
+    void wake() {
+        if (wakePipe[1] < 0)
+            return;
+        char wakeByte = 0;
+        // A full pipe already wakes the sender thread up
+        [[maybe_unused]] ssize_t writtenSize = ::write(wakePipe[1], &wakeByte, 1);
+    }
+
+    static int getMillisecondsUntil(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point deadline) {
+        if (deadline <= now)
+            return 0;
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+    }
+
+    /// @brief Sends the batches, connects and reconnects, until the sink is destroyed
+    void run() {
+        std::chrono::steady_clock::time_point stopDeadline{};
+        bool isSending = false;
+        while (true) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            // Polls at least every second, in case the wake pipe couldn't be created
+            int timeout = 1000;
+            bool isStopRequested;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isStopRequested = isStopping;
+                if (isStopRequested && stopDeadline == std::chrono::steady_clock::time_point{})
+                    stopDeadline = now + options.closeTimeout;
+                if (!isSending && pending.size() > 0) {
+                    std::chrono::steady_clock::time_point batchDeadline = oldestLogTime + options.maxLatency;
+                    if (isStopRequested || isFlushRequested || pending.size() >= options.maxBatchSize || now >= batchDeadline) {
+                        std::swap(pending, batch);
+                        pending.clear();
+                        inFlightSize = batch.size();
+                        batchLogsCount = pendingLogsCount;
+                        pendingLogsCount = 0;
+                        isSending = true;
+                    } else {
+                        timeout = getMillisecondsUntil(now, batchDeadline);
+                    }
+                }
+                if (!isSending) {
+                    isFlushRequested = false;
+                    sentCondition.notify_all();
+                    if (isStopRequested)
+                        break;
+                }
+            }
+            if (isSending && sentOffset == 0 && outgoing().empty())
+                prepareBatch();
+
+            if (socketDescriptor < 0 && now >= nextConnectTime)
+                openSocket(now);
+            if (socketDescriptor < 0) {
+                timeout = std::min(timeout, getMillisecondsUntil(now, nextConnectTime));
+            } else if (isSending && !isConnecting && !isWaitingForWrite) {
+                if (options.protocol == NetworkProtocol::UDP ? sendDatagrams() : sendStream()) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch.clear();
+                    request.clear();
+                    sentOffset = 0;
+                    inFlightSize = 0;
+                    isSending = false;
+                    continue;
+                }
+                if (socketDescriptor < 0)
+                    continue;
+            }
+
+            if (isStopRequested) {
+                if (now >= stopDeadline) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    droppedCount.fetch_add(batchLogsCount + pendingLogsCount, std::memory_order_relaxed);
+                    sentCondition.notify_all();
+                    break;
+                }
+                timeout = std::min(timeout, getMillisecondsUntil(now, stopDeadline));
+            }
+            waitForEvents(timeout);
+        }
+        closeSocket(false);
+    }
+
+    /// @brief Returns the data of the batch, as sent to the socket
+    std::string_view outgoing() const {
+        return options.framing == NetworkFraming::OTLP ? request.view() : batch.view();
+    }
+
+    /// @brief Wraps the batch into an OTLP/HTTP request
+    void prepareBatch() {
+        if (options.framing != NetworkFraming::OTLP)
+            return;
+        static constexpr std::string_view otlpSuffix = "]}]}]}";
+        request.clear();
+        request.append("POST ");
+        request.append(options.otlpPath);
+        request.append(" HTTP/1.1\r\nHost: ");
+        request.append(host);
+        request.append(':');
+        request.appendUnsignedInteger(port);
+        request.append("\r\nContent-Type: application/json\r\nContent-Length: ");
+        request.appendUnsignedInteger(otlpPrefix.size() + batch.size() + otlpSuffix.size());
+        request.append("\r\n\r\n");
+        request.append(otlpPrefix);
+        request.append(batch.view());
+        request.append(otlpSuffix);
+    }
+
+    /**
+     * @brief Reads the size of the octet-counted frame at the given offset of the batch
+     * @returns The size of the message, and sets `messageOffset` to its start, or returns 0 if the batch is malformed.
+     */
+    size_t readFrame(size_t offset, size_t& messageOffset) const {
+        const char* begin = batch.data() + offset;
+        const char* end = batch.data() + batch.size();
+        size_t messageSize = 0;
+        std::from_chars_result result = std::from_chars(begin, end, messageSize);
+        if (result.ec != std::errc() || result.ptr == end || *result.ptr != ' ')
+            return 0;
+        messageOffset = static_cast<size_t>(result.ptr + 1 - batch.data());
+        return messageOffset + messageSize <= batch.size() ? messageSize : 0;
+    }
+
+    /**
+     * @brief Sends the rest of the batch through the stream
+     * @returns Whether the whole batch was sent.
+     */
+    bool sendStream() {
+        std::string_view data = outgoing();
+        while (sentOffset < data.size()) {
+            ssize_t sentSize = ::send(socketDescriptor, data.data() + sentOffset, data.size() - sentOffset, sendFlags);
+            if (sentSize >= 0) {
+                sentOffset += static_cast<size_t>(sentSize);
+                sentBytesCount.fetch_add(sentSize, std::memory_order_relaxed);
+                continue;
+            }
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                isWaitingForWrite = true;
+            else
+                closeSocket(true);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sends the rest of the batch as datagrams, one per log, with as few calls as possible
+     * @note A datagram the system refuses (e.g. too large, or after an ICMP error) is dropped.
+     * @returns Whether the whole batch was sent.
+     */
+    bool sendDatagrams() {
+        static constexpr size_t maxDatagramsPerCall = 64;
+        while (sentOffset < batch.size()) {
+#ifdef __linux__
+            struct mmsghdr headers[maxDatagramsPerCall];
+            struct iovec parts[maxDatagramsPerCall];
+            size_t frameEnds[maxDatagramsPerCall];
+            unsigned int datagramsCount = 0;
+            for (size_t offset = sentOffset; offset < batch.size() && datagramsCount < maxDatagramsPerCall; datagramsCount++) {
+                size_t messageOffset;
+                size_t messageSize = readFrame(offset, messageOffset);
+                if (messageSize == 0)
+                    break;
+                parts[datagramsCount] = {const_cast<char*>(batch.data()) + messageOffset, messageSize};
+                headers[datagramsCount] = {};
+                headers[datagramsCount].msg_hdr.msg_iov = &parts[datagramsCount];
+                headers[datagramsCount].msg_hdr.msg_iovlen = 1;
+                offset = messageOffset + messageSize;
+                frameEnds[datagramsCount] = offset;
+            }
+            if (datagramsCount == 0)
+                return true;
+            int sentCount = ::sendmmsg(socketDescriptor, headers, datagramsCount, sendFlags);
+            if (sentCount > 0) {
+                for (int i = 0; i < sentCount; i++) {
+                    sentBytesCount.fetch_add(static_cast<long long>(parts[i].iov_len), std::memory_order_relaxed);
+                }
+                sentOffset = frameEnds[sentCount - 1];
+                continue;
+            }
+            size_t firstFrameEnd = frameEnds[0];
+#else
+            size_t messageOffset;
+            size_t messageSize = readFrame(sentOffset, messageOffset);
+            if (messageSize == 0)
+                return true;
+            if (::send(socketDescriptor, batch.data() + messageOffset, messageSize, sendFlags) >= 0) {
+                sentBytesCount.fetch_add(static_cast<long long>(messageSize), std::memory_order_relaxed);
+                sentOffset = messageOffset + messageSize;
+                continue;
+            }
+            size_t firstFrameEnd = messageOffset + messageSize;
+#endif
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                isWaitingForWrite = true;
+                return false;
+            }
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            sentOffset = firstFrameEnd;
+        }
+        return true;
+    }
+
+    /// @brief Starts connecting to the collector, without blocking
+    void openSocket(std::chrono::steady_clock::time_point now) {
+        struct addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = options.protocol == NetworkProtocol::UDP ? SOCK_DGRAM : SOCK_STREAM;
+        struct addrinfo* addresses = nullptr;
+        std::string service = std::to_string(port);
+        if (::getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+            scheduleReconnect(now);
+            return;
+        }
+        socketDescriptor = ::socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+        if (socketDescriptor >= 0) {
+            ::fcntl(socketDescriptor, F_SETFD, FD_CLOEXEC);
+            ::fcntl(socketDescriptor, F_SETFL, ::fcntl(socketDescriptor, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+            int isEnabled = 1;
+            ::setsockopt(socketDescriptor, SOL_SOCKET, SO_NOSIGPIPE, &isEnabled, sizeof(isEnabled));
+#endif
+            if (options.protocol == NetworkProtocol::TCP) {
+                // The logs are already batched
+                int isNoDelay = 1;
+                ::setsockopt(socketDescriptor, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+            }
+            if (::connect(socketDescriptor, addresses->ai_addr, addresses->ai_addrlen) == 0) {
+                onConnected();
+            } else if (errno == EINPROGRESS) {
+                isConnecting = true;
+            } else {
+                ::close(socketDescriptor);
+                socketDescriptor = -1;
+            }
+        }
+        ::freeaddrinfo(addresses);
+        if (socketDescriptor < 0)
+            scheduleReconnect(now);
+    }
+
+    void onConnected() {
+        isConnecting = false;
+        isWaitingForWrite = false;
+        reconnectDelay = options.minReconnectDelay;
+        isSocketConnected.store(true, std::memory_order_relaxed);
+        connectionsCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void scheduleReconnect(std::chrono::steady_clock::time_point now) {
+        nextConnectTime = now + reconnectDelay;
+        reconnectDelay = std::min(reconnectDelay * 2, options.maxReconnectDelay);
+    }
+
+    /**
+     * @brief Closes the socket
+     * @param isBroken Whether the connection broke : the batch is then sent again from the start of its first unsent
+     *      message, or entirely for an OTLP request, and a reconnection is scheduled.
+     */
+    void closeSocket(bool isBroken) {
+        if (socketDescriptor < 0)
+            return;
+        ::close(socketDescriptor);
+        socketDescriptor = -1;
+        isConnecting = false;
+        isWaitingForWrite = false;
+        isSocketConnected.store(false, std::memory_order_relaxed);
+        if (!isBroken)
+            return;
+        scheduleReconnect(std::chrono::steady_clock::now());
+        if (options.framing == NetworkFraming::OTLP) {
+            sentOffset = 0;
+        } else if (options.protocol == NetworkProtocol::TCP) {
+            size_t frameStart = 0;
+            size_t messageOffset;
+            size_t messageSize;
+            while ((messageSize = readFrame(frameStart, messageOffset)) != 0 && messageOffset + messageSize <= sentOffset) {
+                frameStart = messageOffset + messageSize;
+            }
+            sentOffset = frameStart;
+        }
+    }
+
+    /**
+     * @brief Waits for the sender thread to be woken up, for the socket to be ready, or for the timeout
+     * @note Completes the pending connection, and reads and discards what the collector sends back.
+     */
+    void waitForEvents(int timeout) {
+        struct pollfd descriptors[2] = {{wakePipe[0], POLLIN, 0}, {socketDescriptor, 0, 0}};
+        if (socketDescriptor >= 0) {
+            if (isConnecting || isWaitingForWrite)
+                descriptors[1].events |= POLLOUT;
+            if (!isConnecting && options.protocol == NetworkProtocol::TCP)
+                descriptors[1].events |= POLLIN;
+        }
+        if (::poll(descriptors, 2, timeout) <= 0)
+            return;
+
+        if (descriptors[0].revents & POLLIN) {
+            char wakeBytes[64];
+            while (::read(wakePipe[0], wakeBytes, sizeof(wakeBytes)) > 0) {}
+        }
+
+        short events = descriptors[1].revents;
+        if (socketDescriptor < 0 || events == 0)
+            return;
+        if (isConnecting) {
+            int error = 0;
+            socklen_t errorSize = sizeof(error);
+            if (::getsockopt(socketDescriptor, SOL_SOCKET, SO_ERROR, &error, &errorSize) == 0 && error == 0)
+                onConnected();
+            else
+                closeSocket(true);
+            return;
+        }
+        if (events & POLLOUT)
+            isWaitingForWrite = false;
+        if (events & (POLLIN | POLLHUP | POLLERR)) {
+            char response[4096];
+            while (true) {
+                ssize_t readSize = ::recv(socketDescriptor, response, sizeof(response), 0);
+                if (readSize > 0)
+                    continue;
+                if (readSize < 0 && errno == EINTR)
+                    continue;
+                // With UDP, errors are an ICMP error for a previous datagram : they don't close the socket
+                if ((readSize == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) && options.protocol == NetworkProtocol::TCP)
+                    closeSocket(true);
+                break;
+            }
+        }
+    }
+
+#ifdef MSG_NOSIGNAL
+    static constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+    static constexpr int sendFlags = 0;
+#endif
+
+    std::string host;
+    unsigned short port;
+    NetworkSinkOptions options;
+    std::string syslogHeader;
+    std::string otlpPrefix;
+    /// @brief The log being framed, only used by the thread writing to the sink
+    FormatBuffer frame;
+    FormatBuffer message;
+
+    /// @brief Held while the pending logs are changed, by TinyLog and by the sender thread
+    std::mutex mutex;
+    std::condition_variable sentCondition;
+    /// @brief The framed logs waiting for the next batch
+    FormatBuffer pending;
+    long long pendingLogsCount = 0;
+    /// @brief When the oldest pending log was written to this sink
+    std::chrono::steady_clock::time_point oldestLogTime;
+    /// @brief The size of the batch being sent, counted in the spill buffer along with the pending logs
+    size_t inFlightSize = 0;
+    bool isFlushRequested = false;
+    bool isStopping = false;
+
+    // Only used by the sender thread
+    FormatBuffer batch;
+    long long batchLogsCount = 0;
+    FormatBuffer request;
+    size_t sentOffset = 0;
+    int socketDescriptor = -1;
+    bool isConnecting = false;
+    bool isWaitingForWrite = false;
+    std::chrono::milliseconds reconnectDelay{0};
+    std::chrono::steady_clock::time_point nextConnectTime{};
+
+    int wakePipe[2];
+    std::thread senderThread;
+    std::atomic<bool> isSocketConnected{false};
+    std::atomic<long long> droppedCount{0};
+    std::atomic<long long> sentBytesCount{0};
+    std::atomic<long long> connectionsCount{0};
+};
+#endif
+
+#if TINYLOG_USE_NAMESPACE == 1
+}  // TinyLog
+#endif
+
+/**
+ * @brief Returns a string containing the given expression and its value
+ * @param expression A C++ expression that can be converted to a string
+ * @returns The string `"<EXPRESSION> = <VALUE>"` where `<EXPRESSION>` is the stringified `expression` parameter
+ *      and `<VALUE>` is the value of said expression.
  */
 #define TinyLog_debug_expression(expression) (std::string(#expression) + std::string(" = ") + std::to_string(expression))
 
@@ -348,11 +6584,44 @@ private:
  * @param extras... Any number of strings to be appended to the output
  * @note Automatically fills in the filename and the line number
  * @note The extras argument can be used with the `TinyLog_debug_expression` macro
+ * @note If the log level is below `TINYLOG_COMPILE_MIN_LEVEL`, the whole statement compiles to nothing, and neither
+ *      the message nor the extras are evaluated.
+ * @note If the log level is below the current log level, the message and the extras are not evaluated either.
+ * @note Each statement holds a static `CallSite`, describing it once ; see `CallSite::setEnabled()` to disable it, and
+ *      `CallSite::setSampling()` and `CallSite::setRateLimit()` to limit how often it logs.
+ * @warning Assumes the logger name is `logger`
+ * @warning The log level must be a constant expression.
+ */
+#define TinyLog_log(level, message, ...) TinyLog_logc(logger, level, message, __VA_ARGS__)
+
+/**
+ * @brief Alternative to the `TinyLog_log` macro, with a custom logger name. See the docs at the `TinyLog_log` macro.
+ */
+#define TinyLog_logc(logger, level, message, ...) do { \
+        if constexpr (TINYLOG_NAMESPACE isCompiledLogLevel(level)) { \
+            static TINYLOG_NAMESPACE CallSite tinyLogCallSite(__FILENAME__, __LINE__, level); \
+            if (logger.isEnabledLogLevel(level) && tinyLogCallSite.shouldLog()) { \
+                logger.log(tinyLogCallSite, message, {__VA_ARGS__}); \
+            } \
+        } \
+    } while (0)
+
+/**
+ * @brief Logs the given message along with typed fields, see the docs at the `TinyLog_log` macro.
+ * @param fields... At least one field, created with `field()`.
+ *      Example : `TinyLog_logf(TinyLog::INFO, "Request served", TinyLog::field("status", 200), TinyLog::field("duration", elapsed))`
  * @warning Assumes the logger name is `logger`
  */
-#define TinyLog_log(level, message, ...) logger.log(level, message, {__VA_ARGS__}, __FILENAME__, __LINE__)
+#define TinyLog_logf(level, message, ...) TinyLog_logcf(logger, level, message, __VA_ARGS__)
 
 /**
- * @brief Alternative to the `TinyLog_log_pro` macro, with a custom logger name. See the docs at the `TinyLog_log_pro` macro.
+ * @brief Alternative to the `TinyLog_logf` macro, with a custom logger name. See the docs at the `TinyLog_logf` macro.
  */
-#define TinyLog_logc(logger, level, message, ...) logger.log(level, message, {__VA_ARGS__}, __FILENAME__, __LINE__)
+#define TinyLog_logcf(logger, level, message, ...) do { \
+        if constexpr (TINYLOG_NAMESPACE isCompiledLogLevel(level)) { \
+            static TINYLOG_NAMESPACE CallSite tinyLogCallSite(__FILENAME__, __LINE__, level); \
+            if (logger.isEnabledLogLevel(level) && tinyLogCallSite.shouldLog()) { \
+                logger.log(tinyLogCallSite, message, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
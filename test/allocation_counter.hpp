@@ -0,0 +1,75 @@
+#pragma once
+/**
+ * @file Replaces the global `operator new` and `operator delete` to count the heap allocations of a program.
+ * @note Defines the replacement functions : include it from a single translation unit of the program.
+ */
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+/// @brief How many heap allocations have been made, in every thread
+static std::atomic<long long> allocationsCount{0};
+
+/**
+ * @brief Allocates the given size, counting the allocation
+ * @note Every form of `operator new` and `operator delete` is replaced, so that each allocation function is paired
+ *      with its own deallocation function.
+ */
+static void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    size = (size == 0) ? 1 : size;
+    // aligned_alloc() wants a size multiple of the alignment
+    void* pointer = (alignment <= alignof(std::max_align_t)) ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <streambuf>
+
+#include <tinylog.hpp>
+
+#include "allocation_counter.hpp"
+
+/**
+ * @brief A stream buffer discarding everything written to it, without allocating
+ */
+class DiscardingBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+
+    int_type overflow(int_type character) override {
+        return traits_type::not_eof(character);
+    }
+};
+
+/**
+ * @brief Logs a fixed set of messages, through every kind of call
+ */
+void logMessages(TinyLog::Logger& logger) {
+    int a = 5;
+    TinyLog_log(TinyLog::INFO, "Message without extras");
+    TinyLog_log(TinyLog::WARN, "Message with \"quotes\" and extras", "First extra", "Second extra");
+    logger.log(TinyLog::ERROR, "Message without location", {"Extra"});
+    logger.log<TinyLog::FATAL>("Templated message", {"Extra"}, __FILENAME__, __LINE__);
+    TinyLog_log(TinyLog::DEBUG, "Filtered message", TinyLog_debug_expression(a));
+    TinyLog_logf(TinyLog::INFO, "Message with fields", TinyLog::field("count", a), TinyLog::field("ratio", 0.5),
+                 TinyLog::field("isValid", true), TinyLog::field("name", "Name"), TinyLog::field("elapsed", std::chrono::milliseconds(15)));
+    TinyLog::LogContext context({TinyLog::field("requestId", "Request"), TinyLog::field("tenantId", 42)});
+    TinyLog_log(TinyLog::INFO, "Message with a context");
+}
+
+/**
+ * @brief Logs the same messages many times, and returns how many allocations were made while doing so
+ */
+long long countAllocations(TinyLog::Logger& logger) {
+    // Lets every buffer grow to its steady-state size
+    for (int i = 0; i < 100; i++) {
+        logMessages(logger);
+    }
+    TinyLog::Logger::flush();
+
+    long long allocationsBefore = allocationsCount.load();
+    for (int i = 0; i < 1000; i++) {
+        logMessages(logger);
+    }
+    TinyLog::Logger::flush();
+    return allocationsCount.load() - allocationsBefore;
+}
+
+int main() {
+    DiscardingBuffer discardingBuffer;
+    std::ostream stringStream(&discardingBuffer);
+    std::ostream jsonStream(&discardingBuffer);
+    std::ostream binaryStream(&discardingBuffer);
+    TinyLog::BinarySink binarySink(binaryStream);
+
+    TinyLog::Logger logger(TinyLog::INFO);
+    TinyLog::Logger::enableStringOutput(stringStream);
+    TinyLog::Logger::addStringOutput(stringStream, {}, "%t %-5L %f:%l %m %e");
+    TinyLog::Logger::enableJsonOutput(jsonStream);
+    TinyLog::Logger::enableBinaryOutput(binarySink);
+
+    int failures = 0;
+
+    long long synchronousAllocations = countAllocations(logger);
+    std::cout << "Synchronous mode : " << synchronousAllocations << " allocations" << std::endl;
+    failures += synchronousAllocations != 0;
+
+    TinyLog::Logger::enableAsyncMode(64, TinyLog::AsyncOverflowPolicy::BLOCK);
+    long long asynchronousAllocations = countAllocations(logger);
+    TinyLog::Logger::disableAsyncMode();
+    std::cout << "Asynchronous mode : " << asynchronousAllocations << " allocations" << std::endl;
+    failures += asynchronousAllocations != 0;
+
+    TinyLog::Logger::enableAsyncMode(64, TinyLog::AsyncOverflowPolicy::BLOCK, TinyLog::AsyncQueueMode::PER_THREAD);
+    long long perThreadAllocations = countAllocations(logger);
+    TinyLog::Logger::disableAsyncMode();
+    std::cout << "Asynchronous mode with a queue per thread : " << perThreadAllocations << " allocations" << std::endl;
+    failures += perThreadAllocations != 0;
+
+    TinyLog::Logger::disableOutputs();
+    return failures;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <sys/wait.h>
+
+#include <tinylog.hpp>
+
+/**
+ * @brief Logs into a string file and a JSON array file, then dies in the given way, never flushing the
+ *      outputs itself. Runs in a child process.
+ */
+[[noreturn]] void logThenDie(bool isAsync, int signalNumber) {
+    TinyLog::Logger logger(TinyLog::INFO);
+    TinyLog::FileSinkOptions fileOptions;
+    fileOptions.append = false;
+    TinyLog::FileSink stringSink("crash_log.txt", fileOptions);
+    TinyLog::FileSink jsonSink("crash_log.json", fileOptions);
+    TinyLog::Logger::enableStringOutput(stringSink);
+    TinyLog::Logger::enableJsonOutput(jsonSink);
+    if (isAsync)
+        TinyLog::Logger::enableAsyncMode(1024, TinyLog::AsyncOverflowPolicy::BLOCK);
+    TinyLog::Logger::enableCrashHandler();
+
+    for (int i = 0; i < 100; i++) {
+        TinyLog_log(TinyLog::INFO, "Logged before the crash", TinyLog_debug_expression(i));
+    }
+    if (signalNumber == SIGSEGV) {
+        volatile int* invalidPointer = nullptr;
+        *invalidPointer = 0;
+    }
+    std::abort();
+}
+
+/// @brief Returns the content of the given file
+std::string readFile(const char* path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/// @brief Returns how many times `text` appears in `content`
+size_t countOccurrences(const std::string& content, const std::string& text) {
+    size_t count = 0;
+    for (size_t position = content.find(text); position != std::string::npos; position = content.find(text, position + 1)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Runs `logThenDie()` in a child process, and checks that every log made it to the files
+ * @returns Whether the logs, the log of the crash and the end of the JSON array were written.
+ */
+bool checkCrash(bool isAsync, int signalNumber, const char* signalName) {
+    pid_t child = ::fork();
+    if (child == 0)
+        logThenDie(isAsync, signalNumber);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+
+    std::string stringLogs = readFile("crash_log.txt");
+    std::string jsonLogs = readFile("crash_log.json");
+    std::string crashMessage = std::string("Received signal ") + signalName;
+    bool isValid = WIFSIGNALED(status) && WTERMSIG(status) == signalNumber
+        && countOccurrences(stringLogs, "Logged before the crash") == 100 && countOccurrences(stringLogs, crashMessage) == 1
+        && countOccurrences(jsonLogs, "Logged before the crash") == 100 && countOccurrences(jsonLogs, crashMessage) == 1
+        && jsonLogs.size() >= 2 && jsonLogs.front() == '[' && jsonLogs.back() == ']';
+    std::cout << (isAsync ? "Asynchronous mode, " : "Synchronous mode, ") << signalName << " : " << (isValid ? "every log written" : "logs lost") << std::endl;
+    return isValid;
+}
+
+int main() {
+    int failures = 0;
+    failures += !checkCrash(false, SIGSEGV, "SIGSEGV");
+    failures += !checkCrash(false, SIGABRT, "SIGABRT");
+    failures += !checkCrash(true, SIGSEGV, "SIGSEGV");
+    failures += !checkCrash(true, SIGABRT, "SIGABRT");
+    return failures;
+}
@@ -1,9 +1,16 @@
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 #define TINYLOG_EXTRAS_ON_SEPARATE_LINES 1
 #include <tinylog.hpp>
 
+void level3() {
+    TinyLog::ScopedLogLevel logger(TinyLog::WARN);
+    TinyLog_log(TinyLog::INFO, "Level 3, filtered out");
+    TinyLog_log(TinyLog::WARN, "Level 3");
+}
+
 void level2() {
     TinyLog::Logger logger(TinyLog::INHERIT);
     logger.log(TinyLog::DEBUG, "Level 2", {}, __FILENAME__, __LINE__);
@@ -14,18 +21,22 @@ void level1() {
     TinyLog_log(TinyLog::DEBUG, "Level 1");
 
     level2();
+    level3();
 }
 
 int main() {
-    // Logger setup
-    TinyLog::Logger logger;
+    // Logger setup ; the log files are opened first so that they outlive the outputs, disabled at the end
     std::ofstream logFile("log.txt");
+    std::ofstream jsonLogFile("log.json");
+    std::ofstream ndjsonLogFile("log.ndjson");
+    TinyLog::Logger logger;
     TinyLog::Logger::enableStringOutput(logFile);
     // TinyLog::Logger::addStringOutput(std::cout);
 
     TinyLog::Logger::enableJsonOutput(std::cout);
-    std::ofstream jsonLogFile("log.json");
     TinyLog::Logger::addJsonOutput(jsonLogFile);
+    TinyLog::Logger::addJsonOutput(ndjsonLogFile, TinyLog::JsonFormat::NDJSON);
+    int failures = 0;  // Counted by the tests that check their results
 
     // Logger tests
     logger.log(TinyLog::INFO, "Hello debug users :D");
@@ -35,8 +46,219 @@ int main() {
     TinyLog_log(TinyLog::FATAL, "Debugging an expression", TinyLog_debug_expression(a), TinyLog_debug_expression(a == 5), "Extra string");
 
     TinyLog_log(TinyLog::INFO, "This is a test with \"double quotes\"");
+    TinyLog_logf(TinyLog::WARN, "Typed fields", TinyLog::field("count", a), TinyLog::field("ratio", 0.25), TinyLog::field("isValid", true),
+                 TinyLog::field("name", "TinyLog"), TinyLog::field("elapsed", std::chrono::milliseconds(15)));
+
+#if TINYLOG_HAS_POSIX == 1
+    // File sink tests
+    {
+        TinyLog::FileSinkOptions fileSinkOptions;
+        fileSinkOptions.append = false;
+        fileSinkOptions.syncPolicy = TinyLog::FileSyncPolicy::ON_ERROR;
+        TinyLog::FileSink fileSink("log_file_sink.txt", fileSinkOptions);
+        TinyLog::Logger::addStringOutput(fileSink);
+        TinyLog_log(TinyLog::INFO, "Logged to the file sink");
+        TinyLog_log(TinyLog::ERROR, "Logged to the file sink, then persisted");
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+#endif
+
+    // Batching sink tests ; the logs are written to the file in a single batch, except for the error
+    {
+        std::ofstream batchedLogFile("log_batched.txt");
+        TinyLog::BatchingSink batchingSink(batchedLogFile);
+        TinyLog::Logger::addStringOutput(batchingSink);
+        for (int i = 0; i < 8; i++) {
+            TinyLog_log(TinyLog::INFO, "Logged to the batching sink", TinyLog_debug_expression(i));
+        }
+        TinyLog_log(TinyLog::ERROR, "Logged to the batching sink, then flushed");
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+
+#if TINYLOG_HAS_POSIX == 1
+    // Rolling file sink tests ; archives are compressed with gzip when zlib is available
+    {
+        TinyLog::RollingFileSinkOptions rollingOptions;
+        rollingOptions.maxFileSize = 1024;
+        rollingOptions.maxArchives = 2;
+        rollingOptions.compression = TinyLog::RollingCompression::GZIP;
+        rollingOptions.fileOptions.append = false;
+        TinyLog::RollingFileSink rollingFileSink("log_rolling.txt", rollingOptions);
+        TinyLog::Logger::addStringOutput(rollingFileSink);
+        for (int i = 0; i < 32; i++) {
+            TinyLog_log(TinyLog::INFO, "Logged to the rolling file sink", TinyLog_debug_expression(i));
+        }
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+
+    // Ring file sink tests ; the ring only keeps the last logs
+    {
+        TinyLog::RingFileSinkOptions ringOptions;
+        ringOptions.capacity = 4096;
+        TinyLog::RingFileSink ringFileSink("log_ring.bin", ringOptions);
+        TinyLog::Logger::addStringOutput(ringFileSink);
+        for (int i = 0; i < 64; i++) {
+            TinyLog_log(TinyLog::INFO, "Logged to the ring file sink", TinyLog_debug_expression(i));
+        }
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+
+    // Network sink tests ; the logs are sent as syslog datagrams to a local socket, then written to the file
+    {
+        int collector = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressSize = sizeof(address);
+        ::bind(collector, reinterpret_cast<sockaddr*>(&address), addressSize);
+        ::getsockname(collector, reinterpret_cast<sockaddr*>(&address), &addressSize);
+        {
+            TinyLog::NetworkSinkOptions networkOptions;
+            networkOptions.protocol = TinyLog::NetworkProtocol::UDP;
+            TinyLog::NetworkSink networkSink("127.0.0.1", ntohs(address.sin_port), networkOptions);
+            TinyLog::Logger::addStringOutput(networkSink);
+            for (int i = 0; i < 4; i++) {
+                TinyLog_log(TinyLog::INFO, "Sent by the network sink", TinyLog_debug_expression(i));
+            }
+            networkSink.waitUntilSent(std::chrono::seconds(1));
+            TinyLog::Logger::disableStringOutput();
+            TinyLog::Logger::enableStringOutput(logFile);
+        }
+        std::ofstream networkLogFile("log_network.txt");
+        char datagram[2048];
+        ssize_t datagramSize;
+        while ((datagramSize = ::recv(collector, datagram, sizeof(datagram), MSG_DONTWAIT)) > 0) {
+            networkLogFile.write(datagram, datagramSize) << '\n';
+        }
+        ::close(collector);
+    }
+
+    // Shared memory sink tests ; the logs are written into a ring of a shared memory segment, then collected to the file
+    {
+        std::string segmentName = "/tinylog_test_" + std::to_string(::getpid());
+        TinyLog::SharedMemoryOptions sharedMemoryOptions;
+        sharedMemoryOptions.slotsCount = 2;
+        sharedMemoryOptions.ringCapacity = 64 * 1024;
+        TinyLog::FileSinkOptions collectedFileOptions;
+        collectedFileOptions.append = false;
+        TinyLog::FileSink collectedFileSink("log_collected.txt", collectedFileOptions);
+        {
+            TinyLog::SharedMemoryCollector collector(segmentName, collectedFileSink, sharedMemoryOptions);
+            TinyLog::SharedMemorySink sharedMemorySink(segmentName, sharedMemoryOptions);
+            TinyLog::Logger::addStringOutput(sharedMemorySink);
+            for (int i = 0; i < 4; i++) {
+                TinyLog_log(TinyLog::INFO, "Collected from the shared memory sink", TinyLog_debug_expression(i));
+            }
+            TinyLog::Logger::disableStringOutput();
+            TinyLog::Logger::enableStringOutput(logFile);
+        }
+        TinyLog::SharedMemorySegment::remove(segmentName);
+    }
+#endif
+
+    // Output filter tests ; only the errors are written to the filtered output
+    {
+        std::ofstream errorLogFile("log_errors.txt");
+        TinyLog::Logger::addStringOutput(errorLogFile, TinyLog::ERROR);
+        TinyLog_log(TinyLog::INFO, "Not logged to the errors file");
+        TinyLog_log(TinyLog::ERROR, "Logged to the errors file");
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+
+    // Pattern layout tests ; written with the timestamp first and a padded log level
+    {
+        std::ofstream patternLogFile("log_pattern.txt");
+        TinyLog::Logger::addStringOutput(patternLogFile, {}, "%t %-5L %f:%l %m%E");
+        TinyLog_log(TinyLog::INFO, "Logged with a pattern layout");
+        TinyLog_log(TinyLog::WARN, "Logged with a pattern layout", "First extra", "Second extra");
+        TinyLog::Logger::disableStringOutput();
+        TinyLog::Logger::enableStringOutput(logFile);
+    }
+
+    // Log context tests ; the request ID is added to every log of the scope
+    {
+        TinyLog::LogContext requestContext("requestId", "4bf92f35");
+        TinyLog_log(TinyLog::INFO, "Logged with a context");
+        {
+            TinyLog::LogContext tenantContext({TinyLog::field("tenantId", 42), TinyLog::field("isRetry", false)});
+            TinyLog_log(TinyLog::INFO, "Logged with a nested context", "Extra");
+        }
+    }
+    TinyLog_log(TinyLog::INFO, "Logged without a context");
+
+    // Named logger tests ; net.http inherits the log level of net
+    {
+        TinyLog::NamedLogger& httpLogger = TinyLog::NamedLogger::get("net.http");
+        TinyLog_logc(httpLogger, TinyLog::DEBUG, "Not logged by the named logger");
+        TinyLog::NamedLogger::configure("net=DEBUG");
+        TinyLog_logc(httpLogger, TinyLog::DEBUG, "Logged by the named logger");
+        TinyLog::NamedLogger::setLogLevel("net", TinyLog::INHERIT);
+    }
+
+    // Rate limiting tests ; the statement is rate limited once it is registered, then its summary is logged
+    {
+        TinyLog::CallSite* rateLimitedCallSite = nullptr;
+        for (int i = 0; i < 32; i++) {
+            TinyLog_log(TinyLog::WARN, "Rate limited log", TinyLog_debug_expression(i));
+            // Registered by its first log, the statement is the most recently registered call site
+            if (i == 0) {
+                TinyLog::CallSite::forEach([&](TinyLog::CallSite& callSite) {
+                    if (rateLimitedCallSite == nullptr)
+                        rateLimitedCallSite = &callSite;
+                });
+                rateLimitedCallSite->setRateLimit(1, 3);
+            }
+        }
+        // 3 of the 31 following logs fit in the burst : the others are suppressed, unless the bucket refilled meanwhile
+        std::uint64_t suppressedCount = rateLimitedCallSite->getSuppressedCount();
+        TinyLog::Logger::reportSuppressedLogs();
+        bool isSummarized = rateLimitedCallSite->getSuppressedCount() == 0;
+        std::cerr << "Rate limiting : " << suppressedCount << " logs suppressed, " << (isSummarized ? "summarized" : "not summarized") << std::endl;
+        failures += suppressedCount == 0 || suppressedCount > 28 || !isSummarized;
+    }
+
+    // Timestamp precision tests
+    TinyLog::Logger::setTimestampPrecision(TinyLog::TimestampPrecision::MICROSECONDS);
+    TinyLog_log(TinyLog::INFO, "Timestamp with microseconds");
+    TinyLog::Logger::setTimestampPrecision(TinyLog::TimestampPrecision::SECONDS);
+
+    // Asynchronous mode tests
+    TinyLog::Logger::enableAsyncMode(16, TinyLog::AsyncOverflowPolicy::BLOCK);
+    for (int i = 0; i < 32; i++) {
+        TinyLog_log(TinyLog::WARN, "Asynchronous log", TinyLog_debug_expression(i));
+    }
+    TinyLog::Logger::flush();
+    TinyLog::Logger::disableAsyncMode();
+
+    // Asynchronous mode with a queue per thread tests ; the logs of both threads are merged by timestamp
+    TinyLog::Logger::enableAsyncMode(16, TinyLog::AsyncOverflowPolicy::BLOCK, TinyLog::AsyncQueueMode::PER_THREAD);
+    {
+        std::thread otherThread([&]() {
+            for (int i = 0; i < 16; i++) {
+                TinyLog_log(TinyLog::WARN, "Asynchronous log from another thread", TinyLog_debug_expression(i));
+            }
+        });
+        for (int i = 0; i < 16; i++) {
+            TinyLog_log(TinyLog::WARN, "Asynchronous log from the main thread", TinyLog_debug_expression(i));
+        }
+        otherThread.join();
+    }
+    TinyLog::Logger::flush();
+    TinyLog::Logger::disableAsyncMode();
+
+    // Metrics tests ; written in the Prometheus text format
+    {
+        std::ofstream metricsFile("metrics.prom");
+        metricsFile << TinyLog::Logger::getMetrics().toPrometheus();
+    }
 
     level1();
 
-    return 0;
+    TinyLog::Logger::disableOutputs();
+    return failures;
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+/**
+ * @file Collects the logs of the `TinyLog::SharedMemorySink`s of a host into a single rolling file, until it is
+ *      interrupted.
+ *
+ * Usage : tinylog_collect <name> <output> [maxFileSize] [maxArchives]
+ *      name            The name of the shared memory segment, e.g. /tinylog
+ *      output          The file to write the logs to, rotated once it reaches maxFileSize
+ *      maxFileSize     Size, in bytes, above which the file is rotated, 0 to never rotate
+ *      maxArchives     How many archives are kept
+ *
+ * The geometry of the segment is the default one of `TinyLog::SharedMemoryOptions`.
+ */
+#include <iostream>
+#include <string>
+#include <csignal>
+
+#include <tinylog.hpp>
+
+static volatile std::sig_atomic_t isInterrupted = 0;
+
+extern "C" void onInterrupt(int) {
+    isInterrupted = 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 5) {
+        std::cerr << "Usage : tinylog_collect <name> <output> [maxFileSize] [maxArchives]" << std::endl;
+        return 2;
+    }
+    TinyLog::RollingFileSinkOptions fileOptions;
+    try {
+        if (argc >= 4)
+            fileOptions.maxFileSize = std::stoull(argv[3]);
+        if (argc == 5)
+            fileOptions.maxArchives = std::stoi(argv[4]);
+    } catch (const std::exception&) {
+        std::cerr << "Usage : tinylog_collect <name> <output> [maxFileSize] [maxArchives]" << std::endl;
+        return 2;
+    }
+
+    TinyLog::RollingFileSink output(argv[2], fileOptions);
+    if (!output.isOpen()) {
+        std::cerr << "Cannot open " << argv[2] << std::endl;
+        return 1;
+    }
+    TinyLog::SharedMemoryCollector collector(argv[1], output);
+    if (!collector.isOpen()) {
+        std::cerr << "Cannot open the shared memory segment " << argv[1] << ", or it has another geometry" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    while (!isInterrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return 0;
+}
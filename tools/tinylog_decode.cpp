@@ -0,0 +1,102 @@
+/**
+ * @file Decodes a binary log written by `TinyLog::BinarySink` into the string or JSON format.
+ *
+ * Usage : tinylog_decode [--json|--ndjson] [--precision=s|ms|us] <input> [output]
+ *      --json          Writes the logs as a JSON array rather than as strings
+ *      --ndjson        Writes the logs as newline-delimited JSON, one object per line
+ *      --precision     Precision of the timestamps, seconds by default
+ *      input           The binary log to decode
+ *      output          Where to write the decoded logs, the standard output by default
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <tinylog.hpp>
+
+static int printUsage() {
+    std::cerr << "Usage : tinylog_decode [--json|--ndjson] [--precision=s|ms|us] <input> [output]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    bool isJson = false;
+    bool isNdjson = false;
+    std::string inputPath;
+    std::string outputPath;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--json") {
+            isJson = true;
+        } else if (argument == "--ndjson") {
+            isNdjson = true;
+        } else if (argument == "--precision=s") {
+            TinyLog::Logger::setTimestampPrecision(TinyLog::TimestampPrecision::SECONDS);
+        } else if (argument == "--precision=ms") {
+            TinyLog::Logger::setTimestampPrecision(TinyLog::TimestampPrecision::MILLISECONDS);
+        } else if (argument == "--precision=us") {
+            TinyLog::Logger::setTimestampPrecision(TinyLog::TimestampPrecision::MICROSECONDS);
+        } else if (argument.rfind("--", 0) == 0) {
+            return printUsage();
+        } else if (inputPath.empty()) {
+            inputPath = argument;
+        } else if (outputPath.empty()) {
+            outputPath = argument;
+        } else {
+            return printUsage();
+        }
+    }
+    if (inputPath.empty())
+        return printUsage();
+
+    std::ifstream inputFile(inputPath, std::ios::binary);
+    if (!inputFile) {
+        std::cerr << "Cannot open " << inputPath << std::endl;
+        return 1;
+    }
+    std::stringstream content;
+    content << inputFile.rdbuf();
+    std::string binaryLog = content.str();
+
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath, std::ios::binary);
+        if (!outputFile) {
+            std::cerr << "Cannot open " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = outputPath.empty() ? std::cout : outputFile;
+
+    TinyLog::BinaryLogReader reader(binaryLog);
+    TinyLog::FormatBuffer buffer;
+    TinyLog::LogRecord record{};
+    long long logsCount = 0;
+    if (isJson)
+        output << "[";
+    while (reader.next(record)) {
+        buffer.clear();
+        if (isNdjson) {
+            TinyLog::Logger::formatJson(buffer, record);
+            buffer.append('\n');
+        } else if (isJson) {
+            if (logsCount > 0)
+                buffer.append(',');
+            TinyLog::Logger::formatJson(buffer, record);
+        } else {
+            TinyLog::Logger::formatString(buffer, record);
+        }
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        logsCount++;
+    }
+    if (isJson)
+        output << "]\n";
+    output.flush();
+
+    if (!reader.isGood()) {
+        std::cerr << inputPath << " is not a valid binary log, or is truncated : decoded " << logsCount << " logs" << std::endl;
+        return 1;
+    }
+    return 0;
+}
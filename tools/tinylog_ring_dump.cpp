@@ -0,0 +1,53 @@
+/**
+ * @file Dumps the logs kept in the ring file of a `TinyLog::RingFileSink`, oldest first.
+ *
+ * Usage : tinylog_ring_dump <input> [output]
+ *      input           The ring file to dump
+ *      output          Where to write the logs, the standard output by default
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <tinylog.hpp>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage : tinylog_ring_dump <input> [output]" << std::endl;
+        return 2;
+    }
+    std::string inputPath = argv[1];
+
+    std::ifstream inputFile(inputPath, std::ios::binary);
+    if (!inputFile) {
+        std::cerr << "Cannot open " << inputPath << std::endl;
+        return 1;
+    }
+    std::stringstream content;
+    content << inputFile.rdbuf();
+    std::string ringFile = content.str();
+
+    std::ofstream outputFile;
+    if (argc == 3) {
+        outputFile.open(argv[2], std::ios::binary);
+        if (!outputFile) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = (argc == 3) ? outputFile : std::cout;
+
+    TinyLog::RingFileReader reader(ringFile);
+    std::string_view entry;
+    while (reader.next(entry)) {
+        output.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+    }
+    output.flush();
+
+    if (!reader.isGood()) {
+        std::cerr << inputPath << " is not a valid ring file, or is corrupted" << std::endl;
+        return 1;
+    }
+    return 0;
+}